@@ -53,14 +53,23 @@
  * - LV_STDLIB_RTTHREAD:    RT-Thread implementation
  * - LV_STDLIB_CUSTOM:      Implement the functions externally
  */
+#ifdef KIDDO_SIM
+/*The simulator uses LVGL's own pool so its step reports can show lv_mem_monitor()*/
+#define LV_USE_STDLIB_MALLOC    LV_STDLIB_BUILTIN
+#else
 #define LV_USE_STDLIB_MALLOC    LV_STDLIB_CLIB
+#endif
 #define LV_USE_STDLIB_STRING    LV_STDLIB_CLIB
 #define LV_USE_STDLIB_SPRINTF   LV_STDLIB_CLIB
 
 
 #if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
     /*Size of the memory available for `lv_malloc()` in bytes (>= 2kB)*/
+    #ifdef KIDDO_SIM
+    #define LV_MEM_SIZE (256 * 1024U)         /*[bytes]*/
+    #else
     #define LV_MEM_SIZE (64 * 1024U)          /*[bytes]*/
+    #endif
 
     /*Size of the memory expand for `lv_malloc()` in bytes*/
     #define LV_MEM_POOL_EXPAND_SIZE 0
@@ -108,11 +117,20 @@
  * - LV_OS_RTTHREAD
  * - LV_OS_WINDOWS
  * - LV_OS_CUSTOM */
-#define LV_USE_OS   LV_OS_NONE
+#ifdef KIDDO_SIM
+#define LV_USE_OS   LV_OS_PTHREAD
+#else
+#define LV_USE_OS   LV_OS_FREERTOS
+#endif
 
 #if LV_USE_OS == LV_OS_CUSTOM
     #define LV_OS_CUSTOM_INCLUDE <stdint.h>
 #endif
+#if LV_USE_OS == LV_OS_FREERTOS
+    /* The UI task already uses its notification value to wake from AsyncManager
+     * and the touch IRQ, so LVGL's sync objects use semaphores instead. */
+    #define LV_USE_FREERTOS_TASK_NOTIFY 0
+#endif
 
 /*========================
  * RENDERING CONFIGURATION
@@ -129,7 +147,9 @@
     /* Set the number of draw unit.
      * > 1 requires an operating system enabled in `LV_USE_OS`
      * > 1 means multiply threads will render the screen in parallel */
-    #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+    #ifndef LV_DRAW_SW_DRAW_UNIT_CNT
+    #define LV_DRAW_SW_DRAW_UNIT_CNT    2
+    #endif
 
     /* Use Arm-2D to accelerate the sw render */
     #define LV_USE_DRAW_ARM2D_SYNC      0
@@ -314,7 +334,10 @@
 #define LV_COLOR_MIX_ROUND_OFS  0
 
 /* Add 2 x 32 bit variables to each lv_obj_t to speed up getting style properties */
-#define LV_OBJ_STYLE_CACHE      0
+/* On: 8 bytes per object (a few hundred objects with retained screens and the
+ * pooled library list) buys skipping the style walk for properties an object
+ * never sets; the theme's inherited text font makes that walk common. */
+#define LV_OBJ_STYLE_CACHE      1
 
 /* Add `id` field to `lv_obj_t` */
 #define LV_USE_OBJ_ID           0
@@ -396,27 +419,36 @@
 
 /*Montserrat fonts with ASCII range and some symbols using bpp = 4
  *https://fonts.google.com/specimen/Montserrat*/
-#define LV_FONT_MONTSERRAT_8  1
-#define LV_FONT_MONTSERRAT_10 1
+/*Only the sizes the UI uses (ui/fonts.h). With KIDDO_SUBSET_FONTS, set by
+ *tools/subset_fonts.py, the generated subset fonts replace these entirely.*/
+#ifdef KIDDO_SUBSET_FONTS
+#define LV_FONT_MONTSERRAT_12 0
+#define LV_FONT_MONTSERRAT_14 0
+#define LV_FONT_MONTSERRAT_16 0
+#define LV_FONT_MONTSERRAT_20 0
+#else
 #define LV_FONT_MONTSERRAT_12 1
 #define LV_FONT_MONTSERRAT_14 1
 #define LV_FONT_MONTSERRAT_16 1
-#define LV_FONT_MONTSERRAT_18 1
 #define LV_FONT_MONTSERRAT_20 1
-#define LV_FONT_MONTSERRAT_22 1
-#define LV_FONT_MONTSERRAT_24 1
-#define LV_FONT_MONTSERRAT_26 1
-#define LV_FONT_MONTSERRAT_28 1
-#define LV_FONT_MONTSERRAT_30 1
-#define LV_FONT_MONTSERRAT_32 1
-#define LV_FONT_MONTSERRAT_34 1
-#define LV_FONT_MONTSERRAT_36 1
-#define LV_FONT_MONTSERRAT_38 1
-#define LV_FONT_MONTSERRAT_40 1
-#define LV_FONT_MONTSERRAT_42 1
-#define LV_FONT_MONTSERRAT_44 1
-#define LV_FONT_MONTSERRAT_46 1
-#define LV_FONT_MONTSERRAT_48 1
+#endif
+#define LV_FONT_MONTSERRAT_8  0
+#define LV_FONT_MONTSERRAT_10 0
+#define LV_FONT_MONTSERRAT_18 0
+#define LV_FONT_MONTSERRAT_22 0
+#define LV_FONT_MONTSERRAT_24 0
+#define LV_FONT_MONTSERRAT_26 0
+#define LV_FONT_MONTSERRAT_28 0
+#define LV_FONT_MONTSERRAT_30 0
+#define LV_FONT_MONTSERRAT_32 0
+#define LV_FONT_MONTSERRAT_34 0
+#define LV_FONT_MONTSERRAT_36 0
+#define LV_FONT_MONTSERRAT_38 0
+#define LV_FONT_MONTSERRAT_40 0
+#define LV_FONT_MONTSERRAT_42 0
+#define LV_FONT_MONTSERRAT_44 0
+#define LV_FONT_MONTSERRAT_46 0
+#define LV_FONT_MONTSERRAT_48 0
 
 /*Demonstrate special features*/
 #define LV_FONT_MONTSERRAT_28_COMPRESSED 0  /*bpp = 3*/
@@ -430,10 +462,18 @@
 /*Optionally declare custom fonts here.
  *You can use these fonts as default font too and they will be available globally.
  *E.g. #define LV_FONT_CUSTOM_DECLARE   LV_FONT_DECLARE(my_font_1) LV_FONT_DECLARE(my_font_2)*/
+#ifdef KIDDO_SUBSET_FONTS
+#define LV_FONT_CUSTOM_DECLARE LV_FONT_DECLARE(subset_14)
+#else
 #define LV_FONT_CUSTOM_DECLARE
+#endif
 
 /*Always set a default font*/
+#ifdef KIDDO_SUBSET_FONTS
+#define LV_FONT_DEFAULT &subset_14
+#else
 #define LV_FONT_DEFAULT &lv_font_montserrat_14
+#endif
 
 /*Enable handling large font and/or fonts with a lot of characters.
  *The limit depends on the font size, font face and bpp.
@@ -441,7 +481,11 @@
 #define LV_FONT_FMT_TXT_LARGE 0
 
 /*Enables/disables support for compressed fonts.*/
+#ifdef KIDDO_SUBSET_FONTS
+#define LV_USE_FONT_COMPRESSED 1
+#else
 #define LV_USE_FONT_COMPRESSED 0
+#endif
 
 /*Enable drawing placeholders when glyph dsc is not found*/
 #define LV_USE_FONT_PLACEHOLDER 1
@@ -782,30 +826,37 @@
 
 #endif /*LV_USE_SYSMON*/
 
-/*1: Enable the runtime performance profiler*/
-#define LV_USE_PROFILER 0
+/*1: Enable the runtime performance profiler
+ *Follows the app's TRACE_ENABLE build flag: LVGL's own profiler points
+ *(timer handler, refresh, indev read, layout, draw) then go into the app's
+ *trace buffer (include/trace.h) next to the app's trace points.*/
+#if defined(TRACE_ENABLE) && TRACE_ENABLE
+    #define LV_USE_PROFILER 1
+#else
+    #define LV_USE_PROFILER 0
+#endif
 #if LV_USE_PROFILER
     /*1: Enable the built-in profiler*/
-    #define LV_USE_PROFILER_BUILTIN 1
+    #define LV_USE_PROFILER_BUILTIN 0
     #if LV_USE_PROFILER_BUILTIN
         /*Default profiler trace buffer size*/
         #define LV_PROFILER_BUILTIN_BUF_SIZE (16 * 1024)     /*[bytes]*/
     #endif
 
     /*Header to include for the profiler*/
-    #define LV_PROFILER_INCLUDE "lvgl/src/misc/lv_profiler_builtin.h"
+    #define LV_PROFILER_INCLUDE "trace.h"
 
     /*Profiler start point function*/
-    #define LV_PROFILER_BEGIN    LV_PROFILER_BUILTIN_BEGIN
+    #define LV_PROFILER_BEGIN    trace_begin(__func__)
 
     /*Profiler end point function*/
-    #define LV_PROFILER_END      LV_PROFILER_BUILTIN_END
+    #define LV_PROFILER_END      trace_end(__func__)
 
     /*Profiler start point function with custom tag*/
-    #define LV_PROFILER_BEGIN_TAG LV_PROFILER_BUILTIN_BEGIN_TAG
+    #define LV_PROFILER_BEGIN_TAG(tag) trace_begin(tag)
 
     /*Profiler end point function with custom tag*/
-    #define LV_PROFILER_END_TAG   LV_PROFILER_BUILTIN_END_TAG
+    #define LV_PROFILER_END_TAG(tag)   trace_end(tag)
 #endif
 
 /*1: Enable Monkey test*/
@@ -911,7 +962,11 @@
 #define LV_USE_LINUX_DRM        0
 
 /*Interface for TFT_eSPI*/
+#ifdef KIDDO_SIM
+#define LV_USE_TFT_ESPI         0
+#else
 #define LV_USE_TFT_ESPI         1
+#endif
 
 /*Driver for evdev input devices*/
 #define LV_USE_EVDEV    0
@@ -0,0 +1,65 @@
+#pragma once
+
+// Scoped trace points (touch read, LVGL, show_node, decode, flush, ...)
+// recorded with microsecond timestamps into a RAM ring buffer and dumped
+// over serial as Chrome trace JSON (chrome://tracing or ui.perfetto.dev).
+// Build with -D TRACE_ENABLE=1; otherwise every trace point compiles away.
+//
+// This header is in include/ next to lv_conf.h because LVGL's own sources
+// include it through LV_PROFILER_INCLUDE, so it also has to be valid C.
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 0
+#endif
+
+// 16 bytes per event.
+#ifndef TRACE_BUF_EVENTS
+#define TRACE_BUF_EVENTS 1024
+#endif
+
+#if TRACE_ENABLE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// name must outlive the trace (a literal or __func__); only the pointer is kept.
+void trace_begin(const char* name);
+void trace_end(const char* name);
+
+#ifdef __cplusplus
+}
+
+namespace Trace {
+
+class Scope {
+public:
+    explicit Scope(const char* name) : name(name) { trace_begin(name); }
+    ~Scope() { trace_end(name); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name;
+};
+
+// Start over and stop recording once the buffer is full, so whatever happens
+// next (a slow tap) is kept from its first event instead of being overwritten.
+void arm();
+
+// Print the buffer as Chrome trace JSON between "[TRACE]" marker lines, then
+// clear it and go back to continuous recording.
+void dump();
+
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#endif
+
+#else
+
+#define TRACE_SCOPE(name) do {} while (0)
+
+#endif
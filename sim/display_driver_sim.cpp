@@ -0,0 +1,73 @@
+// DisplayDriver for [env:sim]: LVGL renders into the same two partial draw
+// buffers as on the device and flush copies each area into an in-memory
+// framebuffer instead of sending it over SPI.
+#include "display_driver.h"
+#include "config.h"
+#include "sim.h"
+#include <Arduino.h>
+#include <cstdio>
+
+namespace DisplayDriver {
+
+static uint32_t drawBufA[DRAW_BUF_SIZE / 4];
+static uint32_t drawBufB[DRAW_BUF_SIZE / 4];
+static uint16_t framebuffer[SCREEN_WIDTH * SCREEN_HEIGHT];
+
+static Stats stats = {0, 0};
+
+static void flushCb(lv_display_t* disp, const lv_area_t* area, uint8_t* px) {
+    int32_t w = lv_area_get_width(area);
+    const uint16_t* src = (const uint16_t*)px;
+    for (int32_t y = area->y1; y <= area->y2; y++, src += w) {
+        memcpy(&framebuffer[y * SCREEN_WIDTH + area->x1], src, w * sizeof(uint16_t));
+    }
+    stats.flushes++;
+    lv_display_flush_ready(disp);
+}
+
+lv_display_t* init() {
+    lv_display_t* disp = lv_display_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, drawBufA, drawBufB, DRAW_BUF_SIZE,
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flushCb);
+    return disp;
+}
+
+uint32_t benchmarkActiveScreen(const char* label, int frames) {
+    lv_timer_handler();
+    uint32_t total = 0;
+    for (int i = 0; i < frames; i++) {
+        lv_obj_invalidate(lv_screen_active());
+        uint32_t start = micros();
+        lv_refr_now(NULL);
+        total += micros() - start;
+    }
+    uint32_t avg = frames > 0 ? total / frames : 0;
+    Serial.printf("[DISPLAY] %s: %lu us/frame over %d frames, %d draw unit(s)\n",
+                  label, (unsigned long)avg, frames, LV_DRAW_SW_DRAW_UNIT_CNT);
+    return avg;
+}
+
+Stats takeStats() {
+    Stats s = stats;
+    stats = {0, 0};
+    return s;
+}
+
+}
+
+const uint16_t* sim_framebuffer() {
+    return DisplayDriver::framebuffer;
+}
+
+bool sim_write_screenshot(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+    for (uint16_t px : DisplayDriver::framebuffer) {
+        uint8_t rgb[3] = {(uint8_t)((px >> 8) & 0xF8), (uint8_t)((px >> 3) & 0xFC), (uint8_t)(px << 3)};
+        fwrite(rgb, 1, sizeof(rgb), f);
+    }
+    return fclose(f) == 0;
+}
@@ -0,0 +1,86 @@
+// Host stand-in for the parts of the Arduino-ESP32 core the app uses
+// ([env:sim]). Implemented in sim/sim_arduino.cpp.
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "WString.h"
+// The ESP32 core's Arduino.h pulls in FreeRTOS as well.
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define IRAM_ATTR
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define FALLING 0x02
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// No pins on the host.
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+inline void analogWrite(uint8_t, int) {}
+
+// Writes to stdout. There is no serial input; scenarios drive the UI.
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    void flush() { fflush(stdout); }
+
+    size_t printf(const char* format, ...);
+    size_t print(const char* s) { return fputs(s, stdout) < 0 ? 0 : strlen(s); }
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(char c) { return fputc(c, stdout) < 0 ? 0 : 1; }
+    size_t print(long v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+    size_t print(unsigned long v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(double v, int decimals = 2) { return print(String(v, (unsigned int)decimals)); }
+
+    size_t println() { return print('\n'); }
+    template <typename T>
+    size_t println(const T& v) { return print(v) + println(); }
+    template <typename T>
+    size_t println(const T& v, int format) { return print(v, format) + println(); }
+};
+
+extern HardwareSerial Serial;
+
+// The host heap says nothing about the device's, so these report a fixed
+// SIM_FREE_HEAP; memory in the reports comes from LVGL's own pool instead.
+#ifndef SIM_FREE_HEAP
+#define SIM_FREE_HEAP 160000
+#endif
+
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return SIM_FREE_HEAP; }
+    uint32_t getMinFreeHeap() { return SIM_FREE_HEAP; }
+    void restart();
+};
+
+extern EspClass ESP;
@@ -0,0 +1,59 @@
+// SPIFFS files as host files under a directory chosen by the simulator
+// (sim/sim_fs.cpp). Copies share one handle, as on the device.
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File {
+public:
+    File() = default;
+
+    operator bool() const;
+    size_t read(uint8_t* buf, size_t size);
+    int read();
+    int available();
+    size_t write(const uint8_t* buf, size_t size);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close();
+
+    bool isDirectory() const;
+    File openNextFile(const char* mode = "r");
+    // File name without its directory, and the full SPIFFS path.
+    const char* name() const;
+    const char* path() const;
+
+    struct Impl;
+
+private:
+    explicit File(std::shared_ptr<Impl> impl) : impl(std::move(impl)) {}
+    std::shared_ptr<Impl> impl;
+    friend class SimFS;
+};
+
+class SimFS {
+public:
+    // Host directory that stands for the SPIFFS root.
+    void setRoot(const char* dir);
+
+    bool begin(bool formatOnFail = false);
+    File open(const char* path, const char* mode = "r");
+    File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+namespace fs {
+using ::File;
+}
@@ -0,0 +1,27 @@
+// Every request fails as a refused connection; see WiFi.h.
+#pragma once
+
+#include <Arduino.h>
+#include "WiFi.h"
+
+#define HTTP_CODE_OK 200
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+typedef enum {
+    HTTPC_DISABLE_FOLLOW_REDIRECTS,
+    HTTPC_STRICT_FOLLOW_REDIRECTS,
+    HTTPC_FORCE_FOLLOW_REDIRECTS
+} followRedirects_t;
+
+class HTTPClient {
+public:
+    bool begin(const String&) { return true; }
+    void setTimeout(uint16_t) {}
+    void setFollowRedirects(followRedirects_t) {}
+    int GET() { return HTTPC_ERROR_CONNECTION_REFUSED; }
+    int getSize() { return -1; }
+    String getString() { return String(); }
+    WiFiClient* getStreamPtr() { return nullptr; }
+    bool connected() { return false; }
+    void end() {}
+};
@@ -0,0 +1,50 @@
+// In-memory Preferences: every run starts from defaults, so scenarios are
+// repeatable. All instances share one store, like NVS.
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        ns = name ? name : "";
+        return true;
+    }
+    void end() {}
+
+    bool isKey(const char* key) { return store().count(ns + "/" + key) != 0; }
+    bool remove(const char* key) { return store().erase(ns + "/" + key) != 0; }
+
+    size_t putUChar(const char* key, uint8_t v) { return put(key, std::to_string(v), 1); }
+    size_t putUInt(const char* key, uint32_t v) { return put(key, std::to_string(v), 4); }
+    size_t putInt(const char* key, int32_t v) { return put(key, std::to_string(v), 4); }
+    size_t putBool(const char* key, bool v) { return put(key, v ? "1" : "0", 1); }
+    size_t putString(const char* key, const String& v) { return put(key, v.c_str(), v.length()); }
+
+    uint8_t getUChar(const char* key, uint8_t def = 0) { return (uint8_t)getNumber(key, def); }
+    uint32_t getUInt(const char* key, uint32_t def = 0) { return (uint32_t)getNumber(key, def); }
+    int32_t getInt(const char* key, int32_t def = 0) { return (int32_t)getNumber(key, def); }
+    bool getBool(const char* key, bool def = false) { return getNumber(key, def) != 0; }
+    String getString(const char* key, const String& def = String()) {
+        auto it = store().find(ns + "/" + key);
+        return it == store().end() ? def : String(it->second.c_str());
+    }
+
+private:
+    static std::map<std::string, std::string>& store() {
+        static std::map<std::string, std::string> values;
+        return values;
+    }
+    size_t put(const char* key, const std::string& v, size_t bytes) {
+        store()[ns + "/" + key] = v;
+        return bytes;
+    }
+    long long getNumber(const char* key, long long def) {
+        auto it = store().find(ns + "/" + key);
+        return it == store().end() ? def : std::stoll(it->second);
+    }
+
+    std::string ns;
+};
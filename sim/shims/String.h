@@ -0,0 +1,4 @@
+// Some sources include the Arduino core's String header by this name.
+#pragma once
+
+#include "WString.h"
@@ -0,0 +1,181 @@
+// Arduino String for the host build, backed by std::string. Only what the
+// app and ArduinoJson (ARDUINOJSON_ENABLE_ARDUINO_STRING) use.
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <strings.h>
+#include <utility>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class String {
+public:
+    String() = default;
+    String(const char* s) : str_(s ? s : "") {}
+    String(const char* s, size_t n) : str_(s, n) {}
+    String(const std::string& s) : str_(s) {}
+    explicit String(char c) : str_(1, c) {}
+    explicit String(int v, unsigned char base = 10) : str_(fromSigned(v, base)) {}
+    explicit String(unsigned int v, unsigned char base = 10) : str_(fromUnsigned(v, base)) {}
+    explicit String(long v, unsigned char base = 10) : str_(fromSigned(v, base)) {}
+    explicit String(unsigned long v, unsigned char base = 10) : str_(fromUnsigned(v, base)) {}
+    explicit String(long long v, unsigned char base = 10) : str_(fromSigned(v, base)) {}
+    explicit String(unsigned long long v, unsigned char base = 10) : str_(fromUnsigned(v, base)) {}
+    explicit String(float v, unsigned int decimals = 2) : str_(fromDouble(v, decimals)) {}
+    explicit String(double v, unsigned int decimals = 2) : str_(fromDouble(v, decimals)) {}
+
+    // ArduinoJson clears a String by assigning a null pointer.
+    String& operator=(const char* s) {
+        str_ = s ? s : "";
+        return *this;
+    }
+
+    const char* c_str() const { return str_.c_str(); }
+    unsigned int length() const { return (unsigned int)str_.size(); }
+    bool isEmpty() const { return str_.empty(); }
+    bool reserve(unsigned int size) {
+        str_.reserve(size);
+        return true;
+    }
+
+    char operator[](unsigned int i) const { return i < str_.size() ? str_[i] : 0; }
+    char& operator[](unsigned int i) { return str_[i]; }
+    char charAt(unsigned int i) const { return (*this)[i]; }
+    void setCharAt(unsigned int i, char c) {
+        if (i < str_.size()) str_[i] = c;
+    }
+
+    bool concat(const String& s) {
+        str_ += s.str_;
+        return true;
+    }
+    bool concat(const char* s) {
+        if (!s) return false;
+        str_ += s;
+        return true;
+    }
+    bool concat(const char* s, unsigned int n) {
+        if (!s) return false;
+        str_.append(s, n);
+        return true;
+    }
+    bool concat(char c) {
+        str_ += c;
+        return true;
+    }
+    template <typename T>
+    bool concat(T v) { return concat(String(v)); }
+
+    String& operator+=(const String& s) { concat(s); return *this; }
+    String& operator+=(const char* s) { concat(s); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+    template <typename T>
+    String& operator+=(T v) { concat(String(v)); return *this; }
+
+    bool equals(const String& s) const { return str_ == s.str_; }
+    bool equalsIgnoreCase(const String& s) const {
+        return str_.size() == s.str_.size() && strncasecmp(c_str(), s.c_str(), str_.size()) == 0;
+    }
+    int compareTo(const String& s) const { return str_.compare(s.str_); }
+    bool startsWith(const String& prefix) const { return str_.compare(0, prefix.str_.size(), prefix.str_) == 0; }
+    bool endsWith(const String& suffix) const {
+        return str_.size() >= suffix.str_.size() &&
+               str_.compare(str_.size() - suffix.str_.size(), suffix.str_.size(), suffix.str_) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return pos(str_.find(c, from)); }
+    int indexOf(const String& s, unsigned int from = 0) const { return pos(str_.find(s.str_, from)); }
+    int lastIndexOf(char c) const { return pos(str_.rfind(c)); }
+    int lastIndexOf(const String& s) const { return pos(str_.rfind(s.str_)); }
+
+    String substring(unsigned int from) const { return from < str_.size() ? String(str_.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= str_.size()) return String();
+        return String(str_.substr(from, to - from));
+    }
+
+    void remove(unsigned int index) {
+        if (index < str_.size()) str_.erase(index);
+    }
+    void remove(unsigned int index, unsigned int count) {
+        if (index < str_.size()) str_.erase(index, count);
+    }
+    void replace(const String& from, const String& to) {
+        if (from.str_.empty()) return;
+        for (size_t p = str_.find(from.str_); p != std::string::npos; p = str_.find(from.str_, p + to.str_.size())) {
+            str_.replace(p, from.str_.size(), to.str_);
+        }
+    }
+    void trim() {
+        size_t b = str_.find_first_not_of(" \t\r\n");
+        size_t e = str_.find_last_not_of(" \t\r\n");
+        str_ = b == std::string::npos ? std::string() : str_.substr(b, e - b + 1);
+    }
+    void toLowerCase() {
+        for (char& c : str_) c = (char)tolower((unsigned char)c);
+    }
+    void toUpperCase() {
+        for (char& c : str_) c = (char)toupper((unsigned char)c);
+    }
+
+    long toInt() const { return strtol(c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(c_str(), nullptr); }
+
+    friend bool operator==(const String& a, const String& b) { return a.str_ == b.str_; }
+    friend bool operator==(const String& a, const char* b) { return a.str_ == (b ? b : ""); }
+    friend bool operator==(const char* a, const String& b) { return b == a; }
+    friend bool operator!=(const String& a, const String& b) { return !(a == b); }
+    friend bool operator!=(const String& a, const char* b) { return !(a == b); }
+    friend bool operator!=(const char* a, const String& b) { return !(b == a); }
+    friend bool operator<(const String& a, const String& b) { return a.str_ < b.str_; }
+    friend bool operator>(const String& a, const String& b) { return a.str_ > b.str_; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.str_ + b.str_); }
+    friend String operator+(const String& a, const char* b) { return String(a.str_ + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b.str_); }
+    friend String operator+(const String& a, char c) { return String(a.str_ + c); }
+    template <typename T>
+    friend String operator+(const String& a, T v) { return a + String(v); }
+
+private:
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+
+    static std::string fromUnsigned(unsigned long long v, unsigned char base) {
+        if (base < 2 || base > 16) base = 10;
+        char buf[72];
+        char* p = buf + sizeof(buf) - 1;
+        *p = '\0';
+        do {
+            *--p = "0123456789abcdef"[v % base];
+            v /= base;
+        } while (v);
+        return p;
+    }
+    static std::string fromSigned(long long v, unsigned char base) {
+        if (v < 0 && base == 10) return "-" + fromUnsigned(0ULL - (unsigned long long)v, base);
+        return fromUnsigned((unsigned long long)v, base);
+    }
+    static std::string fromDouble(double v, unsigned int decimals) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        return buf;
+    }
+
+    std::string str_;
+};
+
+// Arduino's type for the result of a chain of +; ArduinoJson adapts both.
+class StringSumHelper : public String {
+public:
+    using String::String;
+    StringSumHelper(const String& s) : String(s) {}
+};
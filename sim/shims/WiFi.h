@@ -0,0 +1,39 @@
+// The simulator is always offline: the library shows installed stories and
+// the remote catalog reports no connection.
+#pragma once
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1 } wifi_mode_t;
+
+typedef enum { WIFI_AUTH_OPEN = 0, WIFI_AUTH_WPA2_PSK = 3 } wifi_auth_mode_t;
+
+class WiFiClient {
+public:
+    int available() { return 0; }
+    size_t readBytes(uint8_t*, size_t) { return 0; }
+};
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t) { return true; }
+    wl_status_t begin() { return WL_DISCONNECTED; }
+    wl_status_t begin(const char*, const char* = nullptr) { return WL_DISCONNECTED; }
+    wl_status_t status() { return WL_DISCONNECTED; }
+    bool isConnected() { return false; }
+    bool disconnect(bool = false, bool = false) { return true; }
+    int16_t scanNetworks() { return 0; }
+    String SSID(uint8_t = 0) { return String(); }
+    int32_t RSSI(uint8_t = 0) { return 0; }
+    wifi_auth_mode_t encryptionType(uint8_t) { return WIFI_AUTH_OPEN; }
+};
+
+inline WiFiClass WiFi;
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+// Audio is silent in the simulator.
+typedef enum { DAC_CHANNEL_1 = 0, DAC_CHANNEL_2 } dac_channel_t;
+
+inline int dac_output_enable(dac_channel_t) { return 0; }
+inline int dac_output_voltage(dac_channel_t, uint8_t) { return 0; }
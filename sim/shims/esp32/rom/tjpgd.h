@@ -0,0 +1,45 @@
+// Declarations of the ESP32 ROM TJpgDec API. The simulator is offline, so
+// no JPEG reaches its file system; jd_prepare() rejects every stream and the
+// decoder takes its "unsupported JPEG" path.
+#pragma once
+
+#include <cstdint>
+
+typedef unsigned int UINT;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef short SHORT;
+
+typedef enum {
+    JDR_OK = 0,
+    JDR_INTR,
+    JDR_INP,
+    JDR_MEM1,
+    JDR_MEM2,
+    JDR_PAR,
+    JDR_FMT1,
+    JDR_FMT2,
+    JDR_FMT3
+} JRESULT;
+
+typedef struct {
+    WORD left, right, top, bottom;
+} JRECT;
+
+typedef struct JDEC JDEC;
+struct JDEC {
+    BYTE msx, msy;
+    WORD width, height;
+    void* device;
+};
+
+inline JRESULT jd_prepare(JDEC* jd, UINT (*)(JDEC*, BYTE*, UINT), void*, UINT, void* device) {
+    jd->msx = jd->msy = 1;
+    jd->width = jd->height = 0;
+    jd->device = device;
+    return JDR_FMT3;
+}
+
+inline JRESULT jd_decomp(JDEC*, UINT (*)(JDEC*, void*, JRECT*), BYTE) {
+    return JDR_FMT3;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+
+inline size_t heap_caps_get_largest_free_block(uint32_t) { return SIM_FREE_HEAP; }
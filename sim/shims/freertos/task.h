@@ -0,0 +1,22 @@
+// Tasks as host threads, with FreeRTOS's direct-to-task notifications
+// (sim/sim_rtos.cpp). Priorities, stack sizes and core affinity are ignored.
+#pragma once
+
+#include "FreeRTOS.h"
+
+struct SimTask;
+typedef SimTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* created);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t core);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+const char* pcTaskGetName(TaskHandle_t task);
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken);
+void vTaskDelay(TickType_t ticks);
@@ -0,0 +1,10 @@
+// Simulator-only hooks shared by the files under sim/.
+#pragma once
+
+#include <cstdint>
+
+// The panel contents as last flushed, SCREEN_WIDTH x SCREEN_HEIGHT RGB565.
+const uint16_t* sim_framebuffer();
+
+// Write the framebuffer as a binary PPM; false if the file can't be written.
+bool sim_write_screenshot(const char* path);
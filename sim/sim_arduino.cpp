@@ -0,0 +1,123 @@
+// Arduino core, esp_timer and FreeRTOS task functions for [env:sim].
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/task.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <mutex>
+#include <string>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+int64_t esp_timer_get_time() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - startTime)
+        .count();
+}
+
+unsigned long millis() {
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)esp_timer_get_time();
+}
+
+void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+void EspClass::restart() {
+    Serial.println("[SIM] ESP.restart() requested, exiting");
+    fflush(stdout);
+    exit(0);
+}
+
+// ---------------- FreeRTOS tasks ----------------
+
+struct SimTask {
+    explicit SimTask(const char* name) : name(name) {}
+
+    std::string name;
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+};
+
+static thread_local SimTask* currentTask = nullptr;
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    // The thread running main() becomes a task on first use.
+    if (!currentTask) currentTask = new SimTask("loopTask");
+    return currentTask;
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    if (!task) task = xTaskGetCurrentTaskHandle();
+    return task->name.c_str();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t, void* param,
+                                   UBaseType_t, TaskHandle_t* created, BaseType_t) {
+    SimTask* task = new SimTask(name ? name : "");
+    if (created) *created = task;
+    std::thread([fn, param, task] {
+        currentTask = task;
+        fn(param);
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* created) {
+    return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, created, 0);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    SimTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(task->lock);
+    auto ready = [task] { return task->notifications > 0; };
+    if (ticksToWait == portMAX_DELAY) {
+        task->wake.wait(guard, ready);
+    } else {
+        task->wake.wait_for(guard, std::chrono::milliseconds(ticksToWait), ready);
+    }
+    uint32_t value = task->notifications;
+    if (value) task->notifications = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifications++;
+    }
+    task->wake.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks);
+}
@@ -0,0 +1,179 @@
+// SPIFFS on a host directory for [env:sim].
+#include <FS.h>
+#include <SPIFFS.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+SimFS SPIFFS;
+
+// Same size as the SPIFFS partition in huge_app.csv.
+static const size_t SIM_SPIFFS_BYTES = 0xF0000;
+
+static std::string rootDir = ".";
+
+struct File::Impl {
+    std::string path;   // SPIFFS path, always starting with '/'
+    std::string name;
+    FILE* fp = nullptr;
+    bool directory = false;
+    std::vector<std::string> entries;
+    size_t nextEntry = 0;
+
+    ~Impl() {
+        if (fp) fclose(fp);
+    }
+};
+
+static std::string normalize(const char* path) {
+    std::string p = path ? path : "/";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    return p;
+}
+
+static std::string hostPath(const std::string& path) {
+    return rootDir + path;
+}
+
+static void makeParents(const std::string& host) {
+    for (size_t slash = host.find('/', 1); slash != std::string::npos; slash = host.find('/', slash + 1)) {
+        mkdir(host.substr(0, slash).c_str(), 0755);
+    }
+}
+
+File::operator bool() const {
+    return impl && (impl->fp || impl->directory);
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    return impl && impl->fp ? fread(buf, 1, size, impl->fp) : 0;
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::available() {
+    return impl && impl->fp ? (int)(size() - position()) : 0;
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    return impl && impl->fp ? fwrite(buf, 1, size, impl->fp) : 0;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!impl || !impl->fp) return false;
+    int whence = mode == SeekCur ? SEEK_CUR : mode == SeekEnd ? SEEK_END : SEEK_SET;
+    return fseek(impl->fp, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    return impl && impl->fp ? (size_t)ftell(impl->fp) : 0;
+}
+
+size_t File::size() const {
+    if (!impl || !impl->fp) return 0;
+    fflush(impl->fp);
+    struct stat st;
+    return fstat(fileno(impl->fp), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() {
+    impl.reset();
+}
+
+bool File::isDirectory() const {
+    return impl && impl->directory;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!impl || !impl->directory || impl->nextEntry >= impl->entries.size()) return File();
+    std::string dir = impl->path == "/" ? "" : impl->path;
+    return SPIFFS.open((dir + "/" + impl->entries[impl->nextEntry++]).c_str(), mode);
+}
+
+const char* File::name() const {
+    return impl ? impl->name.c_str() : "";
+}
+
+const char* File::path() const {
+    return impl ? impl->path.c_str() : "";
+}
+
+void SimFS::setRoot(const char* dir) {
+    rootDir = dir;
+    while (rootDir.size() > 1 && rootDir.back() == '/') rootDir.pop_back();
+}
+
+bool SimFS::begin(bool) {
+    mkdir(rootDir.c_str(), 0755);
+    struct stat st;
+    return stat(rootDir.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+File SimFS::open(const char* path, const char* mode) {
+    auto impl = std::make_shared<File::Impl>();
+    impl->path = normalize(path);
+    impl->name = impl->path.substr(impl->path.rfind('/') + 1);
+    std::string host = hostPath(impl->path);
+
+    struct stat st;
+    if (stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        // Like SPIFFS, a listing holds files only.
+        impl->directory = true;
+        if (DIR* dir = opendir(host.c_str())) {
+            while (dirent* entry = readdir(dir)) {
+                std::string child = host + "/" + entry->d_name;
+                if (stat(child.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+                    impl->entries.push_back(entry->d_name);
+                }
+            }
+            closedir(dir);
+        }
+        return File(impl);
+    }
+
+    std::string flags = mode ? mode : "r";
+    if (flags[0] != 'r') makeParents(host);
+    flags += "b";
+    impl->fp = fopen(host.c_str(), flags.c_str());
+    return impl->fp ? File(impl) : File();
+}
+
+bool SimFS::exists(const char* path) {
+    struct stat st;
+    return stat(hostPath(normalize(path)).c_str(), &st) == 0;
+}
+
+bool SimFS::remove(const char* path) {
+    return ::remove(hostPath(normalize(path)).c_str()) == 0;
+}
+
+bool SimFS::rename(const char* from, const char* to) {
+    return ::rename(hostPath(normalize(from)).c_str(), hostPath(normalize(to)).c_str()) == 0;
+}
+
+size_t SimFS::totalBytes() {
+    return SIM_SPIFFS_BYTES;
+}
+
+static size_t directoryBytes(const std::string& host) {
+    size_t total = 0;
+    DIR* dir = opendir(host.c_str());
+    if (!dir) return 0;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        std::string child = host + "/" + entry->d_name;
+        struct stat st;
+        if (stat(child.c_str(), &st) != 0) continue;
+        total += S_ISDIR(st.st_mode) ? directoryBytes(child) : (size_t)st.st_size;
+    }
+    closedir(dir);
+    return total;
+}
+
+size_t SimFS::usedBytes() {
+    return directoryBytes(rootDir);
+}
@@ -0,0 +1,518 @@
+// Headless simulator for [env:sim]: the full UI (router, every screen, the
+// story reader) on the host, rendering into an in-memory framebuffer and
+// driven by a scripted pointer.
+//
+//   .pio/build/sim/program [--csv FILE] [--fs DIR] [--stories DIR] SCENARIO...
+//
+// Each "step" of a scenario becomes one report row: frames rendered, total
+// and worst render time, UI loop time (handlers plus rendering), objects on
+// the display and LVGL pool use. LVGL runs on a simulated tick advanced in
+// SIM_TICK_MS steps, so animations and timers play out the same way on
+// every run; the reported times are real host microseconds.
+//
+// Scenario commands, one per line ('#' starts a comment):
+//   step NAME                    start a new report row
+//   tap X Y
+//   tap_text TEXT [DX DY]        tap the first visible label containing TEXT
+//                                (quote TEXT when an offset follows)
+//   tap_choice N                 tap the N-th choice of the story page
+//   drag X1 Y1 X2 Y2 [MS]
+//   wait MS
+//   shot FILE.ppm                save the framebuffer
+//   repeat N ... end
+#include <Arduino.h>
+#include <lvgl.h>
+#include <Preferences.h>
+#include <SPIFFS.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "i18n.h"
+#include "file_system.h"
+#include "async_manager.h"
+#include "image_pool.h"
+#include "display_driver.h"
+#include "story_engine.h"
+#include "ui/screens/ui_screens.h"
+#include "ui/router.h"
+#include "styles.h"
+#include "audio.h"
+#include "sim.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+Preferences prefs;
+uint8_t brightness = 200;
+uint8_t story_font_scale = 1;
+bool online_mode = false;
+bool wifi_connected = false;
+
+// Simulated time per UI loop pass.
+#define SIM_TICK_MS 5
+// How long a tap holds the pointer down; spans a couple of indev reads.
+#define SIM_PRESS_MS 60
+// Every action runs the UI at least this long, then until animations and
+// AsyncManager jobs are done (at most SIM_SETTLE_MAX_MS of host time).
+#define SIM_SETTLE_MS 200
+#define SIM_SETTLE_MAX_MS 5000
+
+struct StepReport {
+    std::string name;
+    uint32_t frames = 0;
+    uint64_t renderUs = 0;
+    uint32_t maxFrameUs = 0;
+    uint64_t loopUs = 0;
+    uint32_t objects = 0;
+    size_t memUsed = 0;
+    size_t memMaxUsed = 0;
+    uint8_t memFrag = 0;
+};
+
+static uint32_t simTick = 0;
+static lv_point_t pointer = {0, 0};
+static bool pointerDown = false;
+
+static std::vector<StepReport> reports;
+static StepReport* current = nullptr;
+static uint32_t renderStart = 0;
+
+static uint32_t tick_get_cb() {
+    return simTick;
+}
+
+static void pointer_read(lv_indev_t*, lv_indev_data_t* data) {
+    data->point = pointer;
+    data->state = pointerDown ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+static void render_event_cb(lv_event_t* e) {
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        renderStart = micros();
+        return;
+    }
+    if (!current) return;
+    uint32_t us = micros() - renderStart;
+    current->frames++;
+    current->renderUs += us;
+    if (us > current->maxFrameUs) current->maxFrameUs = us;
+}
+
+// ---------------- UI loop ----------------
+
+// The body of loop() in main.cpp, minus touch polling (the pointer is read
+// on LVGL's indev timer) and the idle wait (time is simulated).
+static void run_for(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += SIM_TICK_MS) {
+        simTick += SIM_TICK_MS;
+        uint32_t start = micros();
+        lv_lock();
+        AsyncManager::process();
+        lv_unlock();
+        lv_timer_handler();
+        audio::update();
+        if (current) current->loopUs += micros() - start;
+    }
+}
+
+static bool busy() {
+    if (lv_anim_count_running() > 0) return true;
+    for (int p = 0; p < AsyncManager::PRIORITY_COUNT; p++) {
+        AsyncManager::Priority priority = (AsyncManager::Priority)p;
+        if (AsyncManager::pendingCount(priority) > 0 || AsyncManager::runningCount(priority) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void settle() {
+    run_for(SIM_SETTLE_MS);
+    uint32_t start = millis();
+    while (busy() && millis() - start < SIM_SETTLE_MAX_MS) {
+        // Workers are real threads, so give them host time as well.
+        delay(1);
+        run_for(SIM_TICK_MS);
+    }
+}
+
+// ---------------- Reports ----------------
+
+static uint32_t count_objects(lv_obj_t* obj) {
+    uint32_t n = 1;
+    uint32_t children = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < children; i++) {
+        n += count_objects(lv_obj_get_child(obj, i));
+    }
+    return n;
+}
+
+static void end_step() {
+    if (!current) return;
+    current->objects = count_objects(lv_screen_active()) + count_objects(lv_layer_top()) +
+                       count_objects(lv_layer_sys());
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    current->memUsed = mon.total_size - mon.free_size;
+    current->memMaxUsed = mon.max_used;
+    current->memFrag = mon.frag_pct;
+    current = nullptr;
+}
+
+static void begin_step(const std::string& name) {
+    end_step();
+    int seen = 0;
+    for (const StepReport& r : reports) {
+        if (r.name == name || r.name.rfind(name + "#", 0) == 0) seen++;
+    }
+    reports.emplace_back();
+    reports.back().name = seen ? name + "#" + std::to_string(seen + 1) : name;
+    current = &reports.back();
+}
+
+static void print_report() {
+    printf("\n%-20s %6s %10s %9s %10s %7s %9s %9s %5s\n", "step", "frames", "render ms",
+           "worst ms", "loop ms", "objects", "mem KB", "peak KB", "frag");
+    for (const StepReport& r : reports) {
+        printf("%-20s %6u %10.2f %9.2f %10.2f %7u %9.1f %9.1f %4u%%\n", r.name.c_str(), r.frames,
+               r.renderUs / 1000.0, r.maxFrameUs / 1000.0, r.loopUs / 1000.0, r.objects,
+               r.memUsed / 1024.0, r.memMaxUsed / 1024.0, r.memFrag);
+    }
+}
+
+static bool write_csv(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "step,frames,render_us,worst_frame_us,loop_us,objects,mem_used,mem_max_used,frag_pct\n");
+    for (const StepReport& r : reports) {
+        fprintf(f, "%s,%u,%llu,%u,%llu,%u,%zu,%zu,%u\n", r.name.c_str(), r.frames,
+                (unsigned long long)r.renderUs, r.maxFrameUs, (unsigned long long)r.loopUs,
+                r.objects, r.memUsed, r.memMaxUsed, r.memFrag);
+    }
+    return fclose(f) == 0;
+}
+
+// ---------------- Actions ----------------
+
+static void tap(int32_t x, int32_t y) {
+    pointer = {x, y};
+    pointerDown = true;
+    run_for(SIM_PRESS_MS);
+    pointerDown = false;
+    settle();
+}
+
+static void drag(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t ms) {
+    // One position per indev read, like a finger sampled by the touch panel.
+    uint32_t moves = ms / LV_DEF_REFR_PERIOD;
+    if (moves == 0) moves = 1;
+    pointer = {x1, y1};
+    pointerDown = true;
+    run_for(LV_DEF_REFR_PERIOD);
+    for (uint32_t i = 1; i <= moves; i++) {
+        pointer.x = x1 + (x2 - x1) * (int32_t)i / (int32_t)moves;
+        pointer.y = y1 + (y2 - y1) * (int32_t)i / (int32_t)moves;
+        run_for(LV_DEF_REFR_PERIOD);
+    }
+    pointerDown = false;
+    settle();
+}
+
+// True if p lies on obj and on every ancestor, none of them hidden.
+static bool visible_at(lv_obj_t* obj, const lv_point_t& p) {
+    for (; obj; obj = lv_obj_get_parent(obj)) {
+        if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return false;
+        lv_area_t area;
+        lv_obj_get_coords(obj, &area);
+        if (!lv_area_is_point_on(&area, &p, 0)) return false;
+    }
+    return true;
+}
+
+static bool find_text(lv_obj_t* obj, const char* text, lv_point_t& at) {
+    if (lv_obj_check_type(obj, &lv_label_class)) {
+        const char* label = lv_label_get_text(obj);
+        const char* match = label ? strstr(label, text) : nullptr;
+        if (match) {
+            lv_point_t letter;
+            lv_label_get_letter_pos(obj, lv_text_encoded_get_char_id(label, match - label), &letter);
+            lv_area_t content;
+            lv_obj_get_content_coords(obj, &content);
+            const lv_font_t* font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+            lv_point_t p = {content.x1 + letter.x + 1,
+                            content.y1 + letter.y + lv_font_get_line_height(font) / 2};
+            if (visible_at(obj, p)) {
+                at = p;
+                return true;
+            }
+        }
+    }
+    uint32_t children = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < children; i++) {
+        if (find_text(lv_obj_get_child(obj, i), text, at)) return true;
+    }
+    return false;
+}
+
+static bool tap_text(const std::string& text, int32_t dx, int32_t dy) {
+    lv_point_t at;
+    // Dropdown lists and message boxes live on the top layer.
+    if (!find_text(lv_layer_top(), text.c_str(), at) &&
+        !find_text(lv_screen_active(), text.c_str(), at)) {
+        return false;
+    }
+    tap(at.x + dx, at.y + dy);
+    return true;
+}
+
+static bool tap_choice(uint32_t n) {
+    lv_obj_t* panel = ui_story_choice_panel();
+    if (!panel || lv_obj_get_screen(panel) != lv_screen_active() || n == 0) return false;
+    if (n > lv_obj_get_child_count(panel)) return false;
+    lv_obj_t* choice = lv_obj_get_child(panel, n - 1);
+    lv_obj_scroll_to_view_recursive(choice, LV_ANIM_OFF);
+    lv_obj_update_layout(choice);
+    lv_area_t area;
+    lv_obj_get_coords(choice, &area);
+    tap((area.x1 + area.x2) / 2, (area.y1 + area.y2) / 2);
+    return true;
+}
+
+// ---------------- Scenarios ----------------
+
+static std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+// Flattens "repeat N ... end" blocks; lines keep their file line numbers.
+static bool expand(const std::vector<std::pair<int, std::string>>& lines, size_t& i,
+                   std::vector<std::pair<int, std::string>>& out, bool nested) {
+    while (i < lines.size()) {
+        const auto& line = lines[i++];
+        std::istringstream in(line.second);
+        std::string cmd;
+        in >> cmd;
+        if (cmd == "end") {
+            if (nested) return true;
+            fprintf(stderr, "line %d: 'end' without 'repeat'\n", line.first);
+            return false;
+        }
+        if (cmd != "repeat") {
+            out.push_back(line);
+            continue;
+        }
+        int count = 0;
+        in >> count;
+        std::vector<std::pair<int, std::string>> body;
+        if (!expand(lines, i, body, true)) return false;
+        for (int r = 0; r < count; r++) {
+            out.insert(out.end(), body.begin(), body.end());
+        }
+    }
+    if (nested) {
+        fprintf(stderr, "'repeat' without 'end'\n");
+        return false;
+    }
+    return true;
+}
+
+static bool run_command(const std::string& line) {
+    std::istringstream in(line);
+    std::string cmd;
+    in >> cmd;
+    if (cmd == "step") {
+        begin_step(trim(line.substr(cmd.size())));
+        return true;
+    }
+    if (cmd == "tap") {
+        int32_t x, y;
+        if (!(in >> x >> y)) return false;
+        tap(x, y);
+        return true;
+    }
+    if (cmd == "tap_text") {
+        std::string rest = trim(line.substr(cmd.size()));
+        std::string text = rest;
+        int32_t dx = 0, dy = 0;
+        if (!rest.empty() && rest[0] == '"') {
+            size_t close = rest.find('"', 1);
+            if (close == std::string::npos) return false;
+            text = rest.substr(1, close - 1);
+            std::istringstream offset(rest.substr(close + 1));
+            offset >> dx >> dy;
+        }
+        return !text.empty() && tap_text(text, dx, dy);
+    }
+    if (cmd == "tap_choice") {
+        uint32_t n;
+        return (in >> n) && tap_choice(n);
+    }
+    if (cmd == "drag") {
+        int32_t x1, y1, x2, y2;
+        uint32_t ms = 300;
+        if (!(in >> x1 >> y1 >> x2 >> y2)) return false;
+        in >> ms;
+        drag(x1, y1, x2, y2, ms);
+        return true;
+    }
+    if (cmd == "wait") {
+        uint32_t ms;
+        if (!(in >> ms)) return false;
+        run_for(ms);
+        return true;
+    }
+    if (cmd == "shot") {
+        std::string path;
+        if (!(in >> path)) return false;
+        lv_refr_now(NULL);
+        return sim_write_screenshot(path.c_str());
+    }
+    return false;
+}
+
+static bool run_scenario(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        fprintf(stderr, "can't open scenario %s\n", path);
+        return false;
+    }
+    std::vector<std::pair<int, std::string>> lines;
+    std::string text;
+    for (int n = 1; std::getline(file, text); n++) {
+        size_t comment = text.find('#');
+        if (comment != std::string::npos) text.erase(comment);
+        text = trim(text);
+        if (!text.empty()) lines.emplace_back(n, text);
+    }
+
+    std::vector<std::pair<int, std::string>> commands;
+    size_t i = 0;
+    if (!expand(lines, i, commands, false)) return false;
+
+    bool ok = true;
+    for (const auto& command : commands) {
+        if (!run_command(command.second)) {
+            fprintf(stderr, "%s:%d: failed: %s\n", path, command.first, command.second.c_str());
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// ---------------- Setup ----------------
+
+static std::string read_host_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+// Installs the bundled stories the way RemoteCatalog does after a download:
+// the story file with its "lang" filled in, then an index entry.
+static void install_stories(const std::string& dir) {
+    JsonDocument catalog;
+    if (deserializeJson(catalog, read_host_file(dir + "/index.json")) != DeserializationError::Ok) {
+        Serial.printf("[SIM] No story catalog in %s\n", dir.c_str());
+        return;
+    }
+    for (JsonObjectConst entry : catalog["stories"].as<JsonArrayConst>()) {
+        String file = entry["file"] | "";
+        String name = entry["name"] | "";
+        String lang = entry["lang"] | "";
+        JsonDocument doc;
+        if (deserializeJson(doc, read_host_file(dir + "/" + file.c_str())) != DeserializationError::Ok) {
+            Serial.printf("[SIM] Skipping unreadable story %s\n", file.c_str());
+            continue;
+        }
+        if (!doc["lang"].is<const char*>()) doc["lang"] = lang;
+        String payload;
+        serializeJson(doc, payload);
+        String localPath = "/" + file;
+        if (!FileSystem::writeFile(localPath, payload) || !FileSystem::addToIndex(localPath, name, lang)) {
+            Serial.printf("[SIM] Failed to install %s\n", file.c_str());
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* csvPath = nullptr;
+    std::string fsDir;
+    std::string storiesDir = "stories";
+    std::vector<const char*> scenarios;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--csv" && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (arg == "--fs" && i + 1 < argc) {
+            fsDir = argv[++i];
+        } else if (arg == "--stories" && i + 1 < argc) {
+            storiesDir = argv[++i];
+        } else {
+            scenarios.push_back(argv[i]);
+        }
+    }
+    if (scenarios.empty()) {
+        fprintf(stderr, "usage: %s [--csv FILE] [--fs DIR] [--stories DIR] SCENARIO...\n", argv[0]);
+        return 2;
+    }
+    if (fsDir.empty()) {
+        char tmp[] = "/tmp/kiddo-sim-XXXXXX";
+        if (!mkdtemp(tmp)) {
+            perror("mkdtemp");
+            return 2;
+        }
+        fsDir = tmp;
+    }
+
+    // Same order as setup() in main.cpp, with the network left out.
+    SPIFFS.setRoot(fsDir.c_str());
+    SPIFFS.begin(true);
+    lv_init();
+    lv_tick_set_cb(tick_get_cb);
+
+    FileSystem::init();
+    ImagePool::init();
+
+    lv_display_t* disp = DisplayDriver::init();
+    lv_display_set_default(disp);
+    ui_theme_init(disp);
+    lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_START, nullptr);
+    lv_display_add_event_cb(disp, render_event_cb, LV_EVENT_RENDER_READY, nullptr);
+    lv_indev_t* indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_display(indev, disp);
+    lv_indev_set_read_cb(indev, pointer_read);
+
+    audio::init();
+    prefs.begin(PNS, false);
+    brightness = prefs.getUChar(PK_BRIGHTNESS, 200);
+    current_language = (Language)prefs.getUInt(PK_LANG, LANG_EN);
+    story_font_scale = prefs.getUChar(PK_STORY_FONT, 1);
+
+    AsyncManager::init();
+    install_stories(storiesDir);
+    story::loadFromFS();
+    ui_story_set_home_cb([]() { ui_router::show_home(); });
+
+    begin_step("boot");
+    ui_router::show_home();
+    settle();
+
+    bool ok = true;
+    for (const char* scenario : scenarios) {
+        ok = run_scenario(scenario) && ok;
+    }
+    end_step();
+
+    print_report();
+    if (csvPath && !write_csv(csvPath)) {
+        fprintf(stderr, "can't write %s\n", csvPath);
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
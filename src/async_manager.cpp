@@ -1,225 +1,731 @@
 #include "async_manager.h"
+#include "config.h"
 #include "file_system.h"
+#include "image_cache.h"
+#include "image_decoder.h"
 #include "image_display.h"
+#include "image_pool.h"
 #include "remote_catalog.h"
+#include "story_engine.h"
+#include "spsc_ring.h"
+#include "trace.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
-#include <freertos/queue.h>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <map>
+#include <vector>
 
 namespace AsyncManager {
 
 enum OperationType {
     OP_LOAD_IMAGE,
     OP_DOWNLOAD_STORY,
-    OP_FETCH_CATALOG
+    OP_FETCH_CATALOG,
+    OP_BACKGROUND
 };
 
-struct OperationRequest {
-    OperationType type;
-    char url[256];
+// Signalled on the UI thread when the target widget is deleted; the worker
+// polls it to skip queued jobs and abort in-flight transfers.
+struct CancelToken {
+    std::atomic<bool> cancelled{false};
+};
+typedef std::shared_ptr<CancelToken> CancelTokenPtr;
+
+// Lives as LV_EVENT_DELETE user data on the target widget.
+struct WidgetBinding {
+    CancelTokenPtr token;
+    String url;
+};
+
+// One widget waiting for an image job to finish.
+struct ImageWaiter {
     lv_obj_t* imgWidget;
-    ImageCallback imageCallback;
-    StoryCallback storyCallback;
-    CatalogCallback catalogCallback;
+    WidgetBinding* binding;
+    ImageCallback callback;
+    bool revealed = false;  // canvas attached while the decode was running
 };
 
-struct OperationResult {
+// Jobs live in a fixed pool owned by the UI thread; only the handle travels
+// through the rings, so the std::function members are never byte-copied.
+struct Job {
     OperationType type;
-    bool success;
-    char resultPath[128];
-    lv_obj_t* imgWidget;
-    ImageCallback imageCallback;
+    Priority priority;
+    String url;
+    CancelTokenPtr token;
+    std::vector<ImageWaiter> waiters;
+    bool prefetched = false;
     StoryCallback storyCallback;
     CatalogCallback catalogCallback;
+    BackgroundTask task;
+    bool success = false;
+    String resultPath;
+    ImageDecoder::DecodedImage decoded = {nullptr, 0, 0};
+    uint16_t* revealPixels = nullptr;  // cache entry shown while decoding
 };
 
-static QueueHandle_t requestQueue = nullptr;
-static QueueHandle_t resultQueue = nullptr;
-static TaskHandle_t workerTask = nullptr;
+struct ClassPolicy {
+    uint8_t maxPending;   // queue depth before backpressure applies
+    uint8_t maxRunning;   // concurrency limit for the class
+    uint8_t reserveIdle;  // workers that must stay free for higher classes
+};
+
+// Prefetch and background work may only start while another worker is idle,
+// so a burst of low-priority downloads can never occupy every worker.
+static const ClassPolicy POLICY[PRIORITY_COUNT] = {
+    /* PRIORITY_VISIBLE_IMAGE */ {8, ASYNC_WORKER_COUNT, 0},
+    /* PRIORITY_CATALOG       */ {4, 1, 0},
+    /* PRIORITY_PREFETCH      */ {8, 1, 1},
+    /* PRIORITY_BACKGROUND    */ {4, 1, 1},
+};
+
+// One ring per direction keeps every ring single-producer/single-consumer.
+// A worker only ever holds one job, so two slots can never overflow.
+struct Worker {
+    TaskHandle_t task;
+    Job* current;
+    SpscRing<Job*, 2> inbox;   // UI -> worker
+    SpscRing<Job*, 2> outbox;  // worker -> UI
+};
+
+// Pending queues, counters and the in-flight map are owned by the UI thread;
+// workers only see the single job handed to them through their inbox.
+static std::deque<Job*> pending[PRIORITY_COUNT];
+static int running[PRIORITY_COUNT] = {0};
+static std::map<String, Job*> inflightImages;
+static Worker workers[ASYNC_WORKER_COUNT];
+// Download -> decode -> present: downloaded images wait here for the
+// decode worker, which produces the scaled RGB565 buffer off the UI core.
+static std::deque<Job*> pendingDecode;
+static Worker decoder;
+static TaskHandle_t uiTask = nullptr;
+// Rows of decoder.current's buffer that are final. Written by the decode
+// task, polled by process() to reveal the image top-down.
+static std::atomic<uint16_t> decodeRowsReady{0};
+static uint16_t decodeRowsShown = 0;
+static Job jobPool[ASYNC_JOB_POOL_SIZE];
+static std::vector<Job*> freeJobs;
 static bool initialized = false;
 
+// Pool exhaustion is reported like a full queue: the caller gets a failure.
+static Job* allocJob() {
+    if (freeJobs.empty()) {
+        Serial.println(initialized ? "[ASYNC_MANAGER] Job pool exhausted"
+                                   : "[ASYNC_MANAGER] Not initialized");
+        return nullptr;
+    }
+    Job* job = freeJobs.back();
+    freeJobs.pop_back();
+    return job;
+}
+
+static void releaseJob(Job* job) {
+    *job = Job();
+    freeJobs.push_back(job);
+}
+
+static bool isCancelled(const CancelTokenPtr& token) {
+    return token && token->cancelled.load();
+}
+
+static void runJob(Job* job) {
+    TRACE_SCOPE("AsyncManager::runJob");
+    switch (job->type) {
+        case OP_LOAD_IMAGE: {
+            if (isCancelled(job->token)) break;
+            String cachedPath = FileSystem::findCachedImage(job->url);
+            if (cachedPath.length() > 0) {
+                job->success = true;
+                job->resultPath = cachedPath;
+                break;
+            }
+            cachedPath = FileSystem::getCachedImagePath(job->url);
+            if (FileSystem::downloadFile(job->url, cachedPath, &job->token->cancelled)) {
+                job->success = true;
+                job->resultPath = cachedPath;
+            } else if (isCancelled(job->token)) {
+                Serial.println("[ASYNC_MANAGER] Image download cancelled: " + job->url);
+            } else {
+                Serial.println("[ASYNC_MANAGER] Image download failed: " + job->url);
+            }
+            break;
+        }
+        case OP_DOWNLOAD_STORY: {
+            String storyId;
+            if (remote_catalog::ensureDownloadedOrIndexed(job->url, &storyId)) {
+                job->success = true;
+                job->resultPath = storyId;
+            }
+            break;
+        }
+        case OP_FETCH_CATALOG:
+            job->success = remote_catalog::fetch();
+            if (!job->success) {
+                Serial.println("[ASYNC_MANAGER] Catalog fetch failed");
+            }
+            break;
+        case OP_BACKGROUND:
+            if (job->task) job->task();
+            job->success = true;
+            break;
+    }
+}
+
 static void workerTaskFunction(void* parameter) {
-    OperationRequest request;
-    
+    Worker* worker = (Worker*)parameter;
+    Job* job = nullptr;
+
     while (true) {
-        if (xQueueReceive(requestQueue, &request, portMAX_DELAY) == pdTRUE) {
-            OperationResult result;
-            result.type = request.type;
-            result.imgWidget = request.imgWidget;
-            result.imageCallback = request.imageCallback;
-            result.storyCallback = request.storyCallback;
-            result.catalogCallback = request.catalogCallback;
-            result.success = false;
-            
-            String url_str = String(request.url);
-            
-            if (request.type == OP_LOAD_IMAGE) {
-                String cachedPath = FileSystem::getCachedImagePath(url_str);
-                
-                if (FileSystem::isImageCached(url_str)) {
-                    result.success = true;
-                    strncpy(result.resultPath, cachedPath.c_str(), sizeof(result.resultPath) - 1);
-                } else {
-                    if (FileSystem::downloadFile(url_str, cachedPath)) {
-                        result.success = true;
-                        strncpy(result.resultPath, cachedPath.c_str(), sizeof(result.resultPath) - 1);
-                    } else {
-                        Serial.println("[ASYNC_MANAGER] Image download failed: " + url_str);
-                        result.success = false;
-                    }
-                }
-            } else if (request.type == OP_DOWNLOAD_STORY) {
-                String storyId;
-                if (remote_catalog::ensureDownloadedOrIndexed(url_str, &storyId)) {
-                    result.success = true;
-                    strncpy(result.resultPath, storyId.c_str(), sizeof(result.resultPath) - 1);
-                } else {
-                    result.success = false;
-                }
-            } else if (request.type == OP_FETCH_CATALOG) {
-                if (remote_catalog::fetch()) {
-                    result.success = true;
-                } else {
-                    Serial.println("[ASYNC_MANAGER] Catalog fetch failed");
-                    result.success = false;
-                }
-            }
-            
-            result.resultPath[sizeof(result.resultPath) - 1] = '\0';
-            
-            if (xQueueSend(resultQueue, &result, portMAX_DELAY) != pdTRUE) {
-                Serial.println("[ASYNC_MANAGER] Failed to send result");
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (worker->inbox.pop(job)) {
+            runJob(job);
+            worker->outbox.push(std::move(job));
+            xTaskNotifyGive(uiTask);
+        }
+    }
+}
+
+static bool needsTranscode(const Job* job) {
+    return IMAGE_CACHE_TRANSCODE && !job->resultPath.endsWith(".bin");
+}
+
+static bool decodeJob(Job* job) {
+    TRACE_SCOPE("decode");
+    if (isCancelled(job->token)) return false;
+    const std::atomic<bool>* abortFlag = &job->token->cancelled;
+    if (job->resultPath.endsWith(".bin")) {
+        return ImageDecoder::readBinFile(job->resultPath, STORY_IMAGE_MAX_WIDTH,
+                                         STORY_IMAGE_MAX_HEIGHT, job->decoded, abortFlag);
+    }
+    auto onRows = [](uint16_t rowsDone) {
+        decodeRowsReady.store(rowsDone);
+        xTaskNotifyGive(uiTask);
+    };
+    if (!ImageDecoder::decodeFile(job->resultPath, STORY_IMAGE_MAX_WIDTH,
+                                  STORY_IMAGE_MAX_HEIGHT, job->decoded, abortFlag, onRows)) {
+        return false;
+    }
+    // Keep the scaled result instead of the original; a failed write just
+    // means the original is decoded again next time.
+    if (needsTranscode(job)) {
+        String binPath = FileSystem::getTranscodedImagePath(job->url);
+        if (ImageDecoder::writeBinFile(binPath, job->decoded)) {
+            FileSystem::deleteFile(job->resultPath);
+            job->resultPath = binPath;
+        }
+    }
+    return true;
+}
+
+static void decodeTaskFunction(void* parameter) {
+    Worker* worker = (Worker*)parameter;
+    Job* job = nullptr;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (worker->inbox.pop(job)) {
+            job->success = decodeJob(job);
+            worker->outbox.push(std::move(job));
+            xTaskNotifyGive(uiTask);
+        }
+    }
+}
+
+// A shared job is only worth finishing while someone still wants it.
+static void updateJobCancellation(Job* job) {
+    if (job->prefetched) return;
+    for (const ImageWaiter& waiter : job->waiters) {
+        if (!isCancelled(waiter.binding->token)) return;
+    }
+    job->token->cancelled.store(true);
+}
+
+static void widget_delete_cb(lv_event_t* e) {
+    WidgetBinding* binding = (WidgetBinding*)lv_event_get_user_data(e);
+    binding->token->cancelled.store(true);
+
+    auto it = inflightImages.find(binding->url);
+    if (it != inflightImages.end()) {
+        updateJobCancellation(it->second);
+    }
+}
+
+static void releaseWaiter(ImageWaiter& waiter) {
+    if (!isCancelled(waiter.binding->token)) {
+        lv_obj_remove_event_cb_with_user_data(waiter.imgWidget, widget_delete_cb, waiter.binding);
+    }
+    delete waiter.binding;
+    waiter.binding = nullptr;
+}
+
+static void removePlaceholder(lv_obj_t* imgWidget) {
+    lv_obj_t* parent = lv_obj_get_parent(imgWidget);
+    if (!parent) return;
+
+    uint32_t child_count = lv_obj_get_child_cnt(parent);
+    for (uint32_t i = 0; i < child_count; i++) {
+        lv_obj_t* child = lv_obj_get_child(parent, i);
+        if (lv_obj_get_user_data(child) &&
+            strcmp((char*)lv_obj_get_user_data(child), "loading_placeholder") == 0) {
+            lv_obj_del(child);
+            break;
+        }
+    }
+}
+
+static bool hasLiveWaiters(const Job* job) {
+    for (const ImageWaiter& waiter : job->waiters) {
+        if (!isCancelled(waiter.binding->token)) return true;
+    }
+    return false;
+}
+
+static String cacheKey(const String& url) {
+    return ImageCache::makeKey(url, STORY_IMAGE_MAX_WIDTH, STORY_IMAGE_MAX_HEIGHT);
+}
+
+// Attach the buffer the decoder is still filling to every live waiter. The
+// cache entry stays incomplete, and holds an extra reference for the
+// pipeline, until finishReveal.
+static void beginReveal(Job* job) {
+    uint16_t live = 0;
+    for (const ImageWaiter& waiter : job->waiters) {
+        if (!isCancelled(waiter.binding->token)) live++;
+    }
+    if (live == 0) return;
+
+    // Published by the decoder before the first row count.
+    ImageDecoder::DecodedImage image = job->decoded;
+    uint16_t* pixels = ImageCache::insert(cacheKey(job->url), image, live + 1, false);
+    job->revealPixels = pixels;
+    for (ImageWaiter& waiter : job->waiters) {
+        if (isCancelled(waiter.binding->token)) continue;
+        removePlaceholder(waiter.imgWidget);
+        waiter.revealed = ImageDisplay::showImage(waiter.imgWidget, pixels,
+                                                  image.width, image.height);
+    }
+}
+
+static void revealDecodeProgress() {
+    Job* job = decoder.current;
+    if (!job) return;
+    uint16_t rows = decodeRowsReady.load();
+    if (rows <= decodeRowsShown) return;
+
+    if (!job->revealPixels) {
+        beginReveal(job);
+        if (!job->revealPixels) return;
+    } else {
+        for (const ImageWaiter& waiter : job->waiters) {
+            if (waiter.revealed && !isCancelled(waiter.binding->token)) {
+                ImageDisplay::invalidateRows(waiter.imgWidget, decodeRowsShown, rows);
             }
         }
     }
+    decodeRowsShown = rows;
+}
+
+// The decode is over: keep the revealed buffer as a normal cache entry, or
+// take the partial image down again if it failed.
+static void finishReveal(Job* job, std::vector<bool>& shown) {
+    uint16_t* pixels = job->revealPixels;
+    uint16_t width = job->decoded.width;
+    uint16_t height = job->decoded.height;
+    job->revealPixels = nullptr;
+    job->decoded.pixels = nullptr;  // owned by the cache since beginReveal
+
+    if (job->success) {
+        ImageCache::markComplete(pixels);
+    } else {
+        ImageCache::discard(pixels);
+    }
+
+    for (size_t i = 0; i < job->waiters.size(); i++) {
+        ImageWaiter& waiter = job->waiters[i];
+        if (isCancelled(waiter.binding->token)) continue;
+
+        if (waiter.revealed && job->success) {
+            ImageDisplay::invalidateRows(waiter.imgWidget, decodeRowsShown, height);
+            shown[i] = true;
+        } else if (waiter.revealed) {
+            ImageDisplay::cleanupImageResources(waiter.imgWidget);
+            lv_obj_clean(waiter.imgWidget);
+        } else if (job->success) {
+            // Attached to the job after the reveal started.
+            ImageCache::retain(pixels);
+            removePlaceholder(waiter.imgWidget);
+            shown[i] = ImageDisplay::showImage(waiter.imgWidget, pixels, width, height);
+        }
+    }
+    ImageCache::release(pixels);
+}
+
+// Without a reveal in progress, the decoded buffer moves into the RAM cache
+// (prefetches included) and every live waiter shows it through its own
+// cache reference.
+static void deliverImage(Job* job) {
+    auto it = inflightImages.find(job->url);
+    if (it != inflightImages.end() && it->second == job) inflightImages.erase(it);
+
+    std::vector<bool> shown(job->waiters.size(), false);
+    if (job->revealPixels) {
+        finishReveal(job, shown);
+    } else if (job->success && job->decoded.pixels) {
+        uint16_t live = 0;
+        for (const ImageWaiter& waiter : job->waiters) {
+            if (!isCancelled(waiter.binding->token)) live++;
+        }
+        uint16_t width = job->decoded.width;
+        uint16_t height = job->decoded.height;
+        uint16_t* pixels = ImageCache::insert(cacheKey(job->url), job->decoded, live);
+        for (size_t i = 0; pixels && i < job->waiters.size(); i++) {
+            ImageWaiter& waiter = job->waiters[i];
+            if (isCancelled(waiter.binding->token)) continue;
+            removePlaceholder(waiter.imgWidget);
+            shown[i] = ImageDisplay::showImage(waiter.imgWidget, pixels, width, height);
+        }
+    }
+    ImageDecoder::release(job->decoded);
+
+    for (ImageWaiter& waiter : job->waiters) {
+        releaseWaiter(waiter);
+    }
+    for (size_t i = 0; i < job->waiters.size(); i++) {
+        if (job->waiters[i].callback) job->waiters[i].callback(shown[i], job->resultPath);
+    }
+}
+
+static void deliver(Job* job) {
+    switch (job->type) {
+        case OP_LOAD_IMAGE:
+            deliverImage(job);
+            break;
+        case OP_DOWNLOAD_STORY:
+            // Reloaded here, not on the worker, so the story list the UI
+            // holds pointers into only changes on this task.
+            if (job->success) story::loadFromFS();
+            if (job->storyCallback) job->storyCallback(job->success, job->resultPath);
+            break;
+        case OP_FETCH_CATALOG:
+        case OP_BACKGROUND:
+            if (job->catalogCallback) job->catalogCallback(job->success);
+            break;
+    }
+}
+
+static void fail(Job* job) {
+    job->success = false;
+    job->resultPath = "";
+    deliver(job);
+    releaseJob(job);
+}
+
+static int idleWorkerCount() {
+    int idle = 0;
+    for (int w = 0; w < ASYNC_WORKER_COUNT; w++) {
+        if (!workers[w].current) idle++;
+    }
+    return idle;
+}
+
+static void purgeCancelled(std::deque<Job*>& queue) {
+    for (auto it = queue.begin(); it != queue.end();) {
+        if (isCancelled((*it)->token)) {
+            Job* job = *it;
+            it = queue.erase(it);
+            fail(job);
+        } else {
+            ++it;
+        }
+    }
+}
+
+static Job* takeNextJob() {
+    int idle = idleWorkerCount();
+    for (int p = 0; p < PRIORITY_COUNT; p++) {
+        purgeCancelled(pending[p]);
+        if (pending[p].empty()) continue;
+        if (running[p] >= POLICY[p].maxRunning) continue;
+        if (idle <= POLICY[p].reserveIdle) continue;
+
+        Job* job = pending[p].front();
+        pending[p].pop_front();
+        return job;
+    }
+    return nullptr;
+}
+
+static void dispatch() {
+    for (int w = 0; w < ASYNC_WORKER_COUNT; w++) {
+        if (workers[w].current) continue;
+
+        Job* job = takeNextJob();
+        if (!job) return;
+
+        workers[w].current = job;
+        running[job->priority]++;
+        workers[w].inbox.push(std::move(job));
+        xTaskNotifyGive(workers[w].task);
+    }
+}
+
+static void dispatchDecode() {
+    while (!decoder.current && !pendingDecode.empty()) {
+        Job* job = pendingDecode.front();
+        pendingDecode.pop_front();
+        if (isCancelled(job->token) || (!hasLiveWaiters(job) && !needsTranscode(job))) {
+            fail(job);
+            continue;
+        }
+        // Give the decoder a slab rather than a fresh heap block, if the
+        // only thing holding them is cached images nobody is showing.
+        while (ImagePool::freeSlabs() == 0 && ImageCache::evictOne()) {
+        }
+        decoder.current = job;
+        decodeRowsReady.store(0);
+        decodeRowsShown = 0;
+        decoder.inbox.push(std::move(job));
+        xTaskNotifyGive(decoder.task);
+    }
+}
+
+static bool submit(Job* job) {
+    std::deque<Job*>& queue = pending[job->priority];
+    purgeCancelled(queue);
+    if (queue.size() >= POLICY[job->priority].maxPending) {
+        if (job->priority != PRIORITY_VISIBLE_IMAGE) {
+            Serial.printf("[ASYNC_MANAGER] Class %d queue full, request rejected\n", job->priority);
+            fail(job);
+            return false;
+        }
+        // The oldest visible request belongs to a node the reader already left.
+        Job* stale = queue.front();
+        queue.pop_front();
+        Serial.println("[ASYNC_MANAGER] Visible queue full, dropping oldest: " + stale->url);
+        fail(stale);
+    }
+
+    queue.push_back(job);
+    dispatch();
+    return true;
 }
 
 void init() {
     if (initialized) return;
-    
-    requestQueue = xQueueCreate(10, sizeof(OperationRequest));
-    resultQueue = xQueueCreate(10, sizeof(OperationResult));
-    
-    if (requestQueue == nullptr || resultQueue == nullptr) {
-        Serial.println("[ASYNC_MANAGER] Failed to create queues");
-        return;
+
+    uiTask = xTaskGetCurrentTaskHandle();
+    for (int w = 0; w < ASYNC_WORKER_COUNT; w++) {
+        Worker& worker = workers[w];
+        worker.current = nullptr;
+        worker.task = nullptr;
+
+        char name[16];
+        snprintf(name, sizeof(name), "AsyncWorker%d", w);
+        xTaskCreate(
+            workerTaskFunction,
+            name,
+            ASYNC_WORKER_STACK,
+            &worker,
+            1,
+            &worker.task
+        );
+
+        if (worker.task == nullptr) {
+            Serial.println("[ASYNC_MANAGER] Failed to create task");
+            return;
+        }
     }
-    
-    xTaskCreate(
-        workerTaskFunction,
-        "AsyncManager",
-        16384,
-        nullptr,
+
+    decoder.current = nullptr;
+    decoder.task = nullptr;
+    xTaskCreatePinnedToCore(
+        decodeTaskFunction,
+        "AsyncDecode",
+        ASYNC_DECODE_STACK,
+        &decoder,
         1,
-        &workerTask
+        &decoder.task,
+        ASYNC_DECODE_CORE
     );
-    
-    if (workerTask == nullptr) {
+    if (decoder.task == nullptr) {
         Serial.println("[ASYNC_MANAGER] Failed to create task");
         return;
     }
-    
+
+    freeJobs.reserve(ASYNC_JOB_POOL_SIZE);
+    for (int i = ASYNC_JOB_POOL_SIZE - 1; i >= 0; i--) {
+        freeJobs.push_back(&jobPool[i]);
+    }
     initialized = true;
 }
 
+static ImageWaiter makeWaiter(const String& url, lv_obj_t* imgWidget, ImageCallback callback) {
+    ImageWaiter waiter;
+    waiter.imgWidget = imgWidget;
+    waiter.binding = new WidgetBinding{std::make_shared<CancelToken>(), url};
+    waiter.callback = callback;
+    lv_obj_add_event_cb(imgWidget, widget_delete_cb, LV_EVENT_DELETE, waiter.binding);
+    return waiter;
+}
+
+// Move a queued job into a higher class; running jobs keep their slot.
+static void promote(Job* job, Priority priority) {
+    if (job->priority <= priority) return;
+    std::deque<Job*>& from = pending[job->priority];
+    for (auto it = from.begin(); it != from.end(); ++it) {
+        if (*it == job) {
+            from.erase(it);
+            job->priority = priority;
+            pending[priority].push_back(job);
+            return;
+        }
+    }
+}
+
 void loadImage(const String& url, lv_obj_t* imgWidget, ImageCallback callback) {
-    if (!initialized) {
-        Serial.println("[ASYNC_MANAGER] Not initialized");
+    if (!imgWidget) {
         if (callback) callback(false, "");
         return;
     }
-    
-    OperationRequest request;
-    request.type = OP_LOAD_IMAGE;
-    strncpy(request.url, url.c_str(), sizeof(request.url) - 1);
-    request.url[sizeof(request.url) - 1] = '\0';
-    request.imgWidget = imgWidget;
-    request.imageCallback = callback;
-    request.storyCallback = nullptr;
-    request.catalogCallback = nullptr;
-    
-    if (xQueueSend(requestQueue, &request, 0) != pdTRUE) {
-        Serial.println("[ASYNC_MANAGER] Request queue full");
+
+    // Already decoded: show it now, no job needed.
+    uint16_t width, height;
+    uint16_t* pixels = ImageCache::acquire(cacheKey(url), width, height);
+    if (pixels) {
+        removePlaceholder(imgWidget);
+        bool shown = ImageDisplay::showImage(imgWidget, pixels, width, height);
+        if (callback) callback(shown, "");
+        return;
+    }
+
+    // Attach to a live job for the same URL; a cancelled one may already be
+    // aborting its transfer, so it is superseded by a fresh job instead.
+    auto it = inflightImages.find(url);
+    if (it != inflightImages.end() && !isCancelled(it->second->token)) {
+        Job* job = it->second;
+        job->waiters.push_back(makeWaiter(url, imgWidget, callback));
+        promote(job, PRIORITY_VISIBLE_IMAGE);
+        dispatch();
+        return;
+    }
+
+    Job* job = allocJob();
+    if (!job) {
         if (callback) callback(false, "");
+        return;
+    }
+    job->type = OP_LOAD_IMAGE;
+    job->priority = PRIORITY_VISIBLE_IMAGE;
+    job->url = url;
+    job->token = std::make_shared<CancelToken>();
+    job->waiters.push_back(makeWaiter(url, imgWidget, callback));
+    if (submit(job)) inflightImages[url] = job;
+}
+
+bool prefetchImage(const String& url) {
+    if (ImageCache::touch(cacheKey(url))) return true;
+
+    auto it = inflightImages.find(url);
+    if (it != inflightImages.end() && !isCancelled(it->second->token)) {
+        it->second->prefetched = true;
+        return true;
     }
+    if (!canSubmit(PRIORITY_PREFETCH)) return false;
+
+    Job* job = allocJob();
+    if (!job) return false;
+    job->type = OP_LOAD_IMAGE;
+    job->priority = PRIORITY_PREFETCH;
+    job->url = url;
+    job->token = std::make_shared<CancelToken>();
+    job->prefetched = true;
+    if (!submit(job)) return false;
+    inflightImages[url] = job;
+    return true;
 }
 
 void downloadStory(const String& filename, StoryCallback callback) {
-    if (!initialized) {
-        Serial.println("[ASYNC_MANAGER] Not initialized");
+    Job* job = allocJob();
+    if (!job) {
         if (callback) callback(false, "");
         return;
     }
-    
-    OperationRequest request;
-    request.type = OP_DOWNLOAD_STORY;
-    strncpy(request.url, filename.c_str(), sizeof(request.url) - 1);
-    request.url[sizeof(request.url) - 1] = '\0';
-    request.imgWidget = nullptr;
-    request.imageCallback = nullptr;
-    request.storyCallback = callback;
-    request.catalogCallback = nullptr;
-    
-    if (xQueueSend(requestQueue, &request, 0) != pdTRUE) {
-        Serial.println("[ASYNC_MANAGER] Request queue full");
-        if (callback) callback(false, "");
-    }
+    job->type = OP_DOWNLOAD_STORY;
+    job->priority = PRIORITY_CATALOG;
+    job->url = filename;
+    job->storyCallback = callback;
+    submit(job);
 }
 
 void fetchCatalog(CatalogCallback callback) {
-    if (!initialized) {
-        Serial.println("[ASYNC_MANAGER] Not initialized");
+    Job* job = allocJob();
+    if (!job) {
         if (callback) callback(false);
         return;
     }
-    
-    OperationRequest request;
-    request.type = OP_FETCH_CATALOG;
-    request.url[0] = '\0';
-    request.imgWidget = nullptr;
-    request.imageCallback = nullptr;
-    request.storyCallback = nullptr;
-    request.catalogCallback = callback;
-    
-    if (xQueueSend(requestQueue, &request, 0) != pdTRUE) {
-        Serial.println("[ASYNC_MANAGER] Request queue full");
-        if (callback) callback(false);
+    job->type = OP_FETCH_CATALOG;
+    job->priority = PRIORITY_CATALOG;
+    job->catalogCallback = callback;
+    submit(job);
+}
+
+bool runInBackground(BackgroundTask task, CatalogCallback done) {
+    Job* job = allocJob();
+    if (!job) {
+        if (done) done(false);
+        return false;
     }
+    job->type = OP_BACKGROUND;
+    job->priority = PRIORITY_BACKGROUND;
+    job->task = task;
+    job->catalogCallback = done;
+    return submit(job);
+}
+
+bool canSubmit(Priority priority) {
+    return initialized && pending[priority].size() < POLICY[priority].maxPending;
+}
+
+int pendingCount(Priority priority) {
+    return (int)pending[priority].size();
+}
+
+int runningCount(Priority priority) {
+    return running[priority];
 }
 
 void process() {
     if (!initialized) return;
-    
-    OperationResult result;
-    while (xQueueReceive(resultQueue, &result, 0) == pdTRUE) {
-        if (result.type == OP_LOAD_IMAGE && result.imageCallback) {
-            if (result.success) {
-                if (result.imgWidget && lv_obj_is_valid(result.imgWidget)) {
-                    lv_obj_t* parent = lv_obj_get_parent(result.imgWidget);
-                    if (parent) {
-                        uint32_t child_count = lv_obj_get_child_cnt(parent);
-                        for (uint32_t i = 0; i < child_count; i++) {
-                            lv_obj_t* child = lv_obj_get_child(parent, i);
-                            if (lv_obj_get_user_data(child) && 
-                                strcmp((char*)lv_obj_get_user_data(child), "loading_placeholder") == 0) {
-                                lv_obj_del(child);
-                                break;
-                            }
-                        }
-                    }
-                    
-                    if (!ImageDisplay::displayJpegFromFile(String(result.resultPath), result.imgWidget)) {
-                        Serial.println("[ASYNC_MANAGER] Failed to display JPEG");
-                    }
-                }
+    TRACE_SCOPE("AsyncManager::process");
+
+    Job* job = nullptr;
+    for (int w = 0; w < ASYNC_WORKER_COUNT; w++) {
+        while (workers[w].outbox.pop(job)) {
+            workers[w].current = nullptr;
+            running[job->priority]--;
+
+            // Prefetched originals also go through the decoder to be transcoded.
+            if (job->type == OP_LOAD_IMAGE && job->success &&
+                (hasLiveWaiters(job) || needsTranscode(job))) {
+                pendingDecode.push_back(job);
+                continue;
             }
-            result.imageCallback(result.success, String(result.resultPath));
-        } else if (result.type == OP_DOWNLOAD_STORY && result.storyCallback) {
-            result.storyCallback(result.success, String(result.resultPath));
-        } else if (result.type == OP_FETCH_CATALOG && result.catalogCallback) {
-            result.catalogCallback(result.success);
+            deliver(job);
+            releaseJob(job);
         }
     }
+
+    while (decoder.outbox.pop(job)) {
+        decoder.current = nullptr;
+        deliver(job);
+        releaseJob(job);
+    }
+
+    revealDecodeProgress();
+    ImageCache::trim();
+    dispatch();
+    dispatchDecode();
 }
 
-}
\ No newline at end of file
+}
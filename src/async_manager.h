@@ -6,18 +6,45 @@
 
 namespace AsyncManager {
 
+// Scheduling classes, highest priority first. A worker always picks the
+// highest class that has pending work and is below its concurrency limit.
+enum Priority {
+    PRIORITY_VISIBLE_IMAGE = 0,
+    PRIORITY_CATALOG,
+    PRIORITY_PREFETCH,
+    PRIORITY_BACKGROUND,
+    PRIORITY_COUNT
+};
+
 typedef std::function<void(bool success, const String& cachedPath)> ImageCallback;
 typedef std::function<void(bool success, const String& storyId)> StoryCallback;
 typedef std::function<void(bool success)> CatalogCallback;
+typedef std::function<void()> BackgroundTask;
 
+// Call from the task that runs process(); workers wake it with a task
+// notification whenever a result is ready.
 void init();
 
 void loadImage(const String& url, lv_obj_t* imgWidget, ImageCallback callback);
 
+// Warm the image cache for a URL that is likely to be shown soon.
+// Returns false without queueing when the prefetch class is saturated.
+bool prefetchImage(const String& url);
+
 void downloadStory(const String& filename, StoryCallback callback);
 
 void fetchCatalog(CatalogCallback callback);
 
+// Run work on a worker; done is invoked on the UI thread afterwards.
+bool runInBackground(BackgroundTask task, CatalogCallback done = nullptr);
+
+// Backpressure: true while the class still has room in its pending queue.
+bool canSubmit(Priority priority);
+
+int pendingCount(Priority priority);
+
+int runningCount(Priority priority);
+
 void process();
 
-}
\ No newline at end of file
+}
@@ -70,6 +70,11 @@ namespace audio
         g_click_pos = 0;
         g_playing = true;
     }
+
+    bool busy()
+    {
+        return g_playing;
+    }
 }
 
 static void btn_click_sound_cb(lv_event_t *e)
@@ -7,6 +7,8 @@ namespace audio {
   void init();
   void update();
   void play_click();
+  // True while samples are still being clocked out by update().
+  bool busy();
 }
 
 void ui_add_click_sound(lv_obj_t* btn);
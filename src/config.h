@@ -35,6 +35,80 @@
 #define LV_COLOR_DEPTH 16
 #endif
 #define DRAW_BUF_SIZE (SCREEN_WIDTH * SCREEN_HEIGHT / 10 * (LV_COLOR_DEPTH / 8))
+// Render into one draw buffer while the other is sent to the panel by SPI
+// DMA (display_driver.cpp). 0 falls back to LVGL's single-buffer
+// lv_tft_espi driver.
+#ifndef DISPLAY_DMA_FLUSH
+#define DISPLAY_DMA_FLUSH 1
+#endif
+// Log creation time, heap use and full-frame render times of the home,
+// library and story screens at the end of setup(), and story node build and
+// tap-to-frame times on every choice. Compare builds with
+// -D LV_DRAW_SW_DRAW_UNIT_CNT=1 and =2, or with LV_OBJ_STYLE_CACHE 0 and 1.
+#ifndef DISPLAY_BENCHMARK
+#define DISPLAY_BENCHMARK 0
+#endif
+
+// ---------------- Main loop / power ----------------
+// Upper bound on how long loop() sleeps when LVGL has no timer due
+#ifndef UI_IDLE_MAX_WAIT_MS
+#define UI_IDLE_MAX_WAIT_MS 500
+#endif
+
+// ---------------- Performance monitor ----------------
+// Sample period of the serial record and HUD (perf_monitor.h); the monitor
+// itself is switched at runtime with "perf off|log|hud" on the serial port.
+// Latency tracing (include/trace.h) needs a build with -D TRACE_ENABLE=1.
+#ifndef PERF_MONITOR_PERIOD_MS
+#define PERF_MONITOR_PERIOD_MS 1000
+#endif
+
+// ---------------- Async job scheduler ----------------
+// Workers shared by all priority classes (see async_manager.h).
+#ifndef ASYNC_WORKER_COUNT
+#define ASYNC_WORKER_COUNT 2
+#endif
+#ifndef ASYNC_WORKER_STACK
+#define ASYNC_WORKER_STACK 16384
+#endif
+// Image decode runs on its own task on the core LVGL does not use
+// (the Arduino loop runs on core 1).
+#ifndef ASYNC_DECODE_CORE
+#define ASYNC_DECODE_CORE 0
+#endif
+#ifndef ASYNC_DECODE_STACK
+#define ASYNC_DECODE_STACK 8192
+#endif
+// Preallocated job slots: every class queue full plus the running and decode stages
+#ifndef ASYNC_JOB_POOL_SIZE
+#define ASYNC_JOB_POOL_SIZE 32
+#endif
+
+// ---------------- Story images ----------------
+// Images are scaled to fit this box (the story column is 228px wide).
+#define STORY_IMAGE_MAX_WIDTH 220
+#define STORY_IMAGE_MAX_HEIGHT 140
+// After download, store the scaled RGB565 result as an LVGL .bin image and
+// drop the JPEG, so showing a cached image is a plain sequential read.
+#ifndef IMAGE_CACHE_TRANSCODE
+#define IMAGE_CACHE_TRANSCODE 1
+#endif
+// Decoded images live in slabs reserved at boot, sized for one full story image.
+#ifndef IMAGE_SLAB_COUNT
+#define IMAGE_SLAB_COUNT 2
+#endif
+#define IMAGE_SLAB_BYTES (STORY_IMAGE_MAX_WIDTH * STORY_IMAGE_MAX_HEIGHT * 2)
+// Library cover thumbnails, generated once when a story is installed.
+#define THUMB_WIDTH 48
+#define THUMB_HEIGHT 36
+// Decoded images kept in RAM (two full-size story images by default); the
+// cache is trimmed while free heap is below IMAGE_CACHE_MIN_FREE_HEAP.
+#ifndef IMAGE_CACHE_BUDGET
+#define IMAGE_CACHE_BUDGET (2 * STORY_IMAGE_MAX_WIDTH * STORY_IMAGE_MAX_HEIGHT * 2)
+#endif
+#ifndef IMAGE_CACHE_MIN_FREE_HEAP
+#define IMAGE_CACHE_MIN_FREE_HEAP 48000
+#endif
 
 // ---------------- Touch calibration (adjust if needed) ----------------
 // #define TOUCH_SWAP_XY
@@ -64,12 +138,26 @@
 #define PK_STORY_FONT "storyf"
 #define PK_ONLINE_MODE "onmode"
 #define PK_CATALOG_URL "caturl"
+#define PK_PERF_MODE "perf"
 
 // ---------------- Remote catalog ----------------
 #ifndef REMOTE_CATALOG_URL
 #define REMOTE_CATALOG_URL "https://raw.githubusercontent.com/migueltarga/kiddo/refs/heads/main/stories/index.json"
 #endif
 
+// ---------------- Story library ----------------
+// The library list is virtualized: a fixed pool of row buttons is positioned
+// and rebound while scrolling, so it costs the same for 10 or 1000 stories.
+#ifndef LIBRARY_ROW_HEIGHT
+#define LIBRARY_ROW_HEIGHT 36
+#endif
+#define LIBRARY_ROW_GAP 2
+// Rows kept alive: the ~7 visible in the 262 px list plus a margin above and
+// below so a fling rebinds rows before they scroll into view.
+#ifndef LIBRARY_POOL_ROWS
+#define LIBRARY_POOL_ROWS 12
+#endif
+
 // Backlight helpers
 inline void backlight_init() { pinMode(LCD_BACKLIGHT_PIN, OUTPUT); }
 inline void backlight_write(uint8_t v) { analogWrite(LCD_BACKLIGHT_PIN, v); }
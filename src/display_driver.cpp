@@ -0,0 +1,84 @@
+#include "display_driver.h"
+#include "config.h"
+#include "trace.h"
+#include <TFT_eSPI.h>
+
+extern TFT_eSPI tft;
+
+namespace DisplayDriver {
+
+// Static DRAM is DMA-capable on the ESP32.
+static uint32_t drawBufA[DRAW_BUF_SIZE / 4];
+#if DISPLAY_DMA_FLUSH
+static uint32_t drawBufB[DRAW_BUF_SIZE / 4];
+#endif
+
+static Stats stats = {0, 0};
+
+#if DISPLAY_DMA_FLUSH
+// Starts the transfer and returns; LVGL renders the next area into the
+// other buffer and calls waitCb before it reuses this one.
+static void flushCb(lv_display_t* disp, const lv_area_t* area, uint8_t* px) {
+    TRACE_SCOPE("flush");
+    uint32_t w = lv_area_get_width(area);
+    uint32_t h = lv_area_get_height(area);
+    // The ILI9341 takes RGB565 big-endian over SPI and LVGL 9.2 only renders
+    // native order, so one word-wise pass here replaces TFT_eSPI's swapping
+    // push (setSwapBytes stays false).
+    lv_draw_sw_rgb565_swap(px, w * h);
+    tft.pushImageDMA(area->x1, area->y1, w, h, (uint16_t*)px);
+}
+
+static void waitCb(lv_display_t* disp) {
+    TRACE_SCOPE("flush_wait");
+    uint32_t start = micros();
+    tft.dmaWait();
+    uint32_t end = micros();
+    stats.flushes++;
+    stats.waitUs += end - start;
+}
+#endif
+
+lv_display_t* init() {
+#if DISPLAY_DMA_FLUSH
+    tft.setSwapBytes(false);
+    if (tft.initDMA()) {
+        // TFT_eSPI keeps the bus between DMA transfers; nothing else uses it.
+        tft.startWrite();
+
+        lv_display_t* disp = lv_display_create(SCREEN_WIDTH, SCREEN_HEIGHT);
+        lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+        lv_display_set_buffers(disp, drawBufA, drawBufB, sizeof(drawBufA), LV_DISPLAY_RENDER_MODE_PARTIAL);
+        lv_display_set_flush_cb(disp, flushCb);
+        lv_display_set_flush_wait_cb(disp, waitCb);
+        Serial.println("[DISPLAY] Double-buffered DMA flush");
+        return disp;
+    }
+    Serial.println("[DISPLAY] DMA unavailable, using single buffer");
+#endif
+    return lv_tft_espi_create(SCREEN_WIDTH, SCREEN_HEIGHT, drawBufA, sizeof(drawBufA));
+}
+
+uint32_t benchmarkActiveScreen(const char* label, int frames) {
+    // Let layout and pending timers settle so only drawing is measured.
+    lv_timer_handler();
+    uint32_t total = 0;
+    for (int i = 0; i < frames; i++) {
+        lv_obj_invalidate(lv_screen_active());
+        uint32_t start = micros();
+        lv_refr_now(NULL);
+        total += micros() - start;
+    }
+    uint32_t avg = frames > 0 ? total / frames : 0;
+    Serial.printf("[DISPLAY] %s: %lu us/frame over %d frames, %d draw unit(s)\n",
+                  label, (unsigned long)avg, frames, LV_DRAW_SW_DRAW_UNIT_CNT);
+    return avg;
+}
+
+Stats takeStats() {
+    Stats s = stats;
+    stats = {0, 0};
+    return s;
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <lvgl.h>
+
+namespace DisplayDriver {
+
+// Create the LVGL display for the TFT. With DISPLAY_DMA_FLUSH it uses two
+// DRAW_BUF_SIZE buffers and DMA flushing; otherwise lv_tft_espi.
+lv_display_t* init();
+
+struct Stats {
+    uint32_t flushes;
+    uint32_t waitUs;    // time LVGL spent blocked on a transfer still in flight
+};
+
+// Invalidate and synchronously redraw the active screen `frames` times and
+// log the average frame time, tagged with the number of draw units.
+uint32_t benchmarkActiveScreen(const char* label, int frames);
+
+// Counters since the last call. Transfer time not spent in waitUs overlapped
+// rendering (tools/flush_sim.py models the expected ratio).
+Stats takeStats();
+
+}
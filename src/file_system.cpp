@@ -4,10 +4,14 @@
 #include <MD5Builder.h>
 #include <HTTPClient.h>
 #include <WiFi.h>
+#include <mutex>
 
 namespace FileSystem {
 
 static bool fs_initialized = false;
+// index.json is read, modified and written back from the UI task and both
+// workers; held across the whole update so none of them is lost.
+static std::recursive_mutex indexLock;
 
 static void* fs_open(lv_fs_drv_t* drv, const char* path, lv_fs_mode_t mode) {
     const char* flags = "";
@@ -103,43 +107,34 @@ bool init() {
     return true;
 }
 
+// These go to SPIFFS directly rather than through the LVGL "S:" driver, so
+// worker tasks can use them without taking the LVGL lock.
 bool exists(const String& path) {
-    lv_fs_file_t file;
-    lv_fs_res_t res = lv_fs_open(&file, ("S:" + path).c_str(), LV_FS_MODE_RD);
-    if (res == LV_FS_RES_OK) {
-        lv_fs_close(&file);
-        return true;
-    }
-    return false;
+    return SPIFFS.exists(path);
 }
 
 String readFile(const String& path) {
-    lv_fs_file_t file;
-    if (lv_fs_open(&file, ("S:" + path).c_str(), LV_FS_MODE_RD) != LV_FS_RES_OK) {
+    File file = SPIFFS.open(path, "r");
+    if (!file) {
         return "";
     }
     
-    uint32_t size;
-    lv_fs_seek(&file, 0, LV_FS_SEEK_END);
-    lv_fs_tell(&file, &size);
-    lv_fs_seek(&file, 0, LV_FS_SEEK_SET);
-    
+    size_t size = file.size();
     if (size == 0) {
-        lv_fs_close(&file);
+        file.close();
         return "";
     }
     
     char* buffer = (char*)malloc(size + 1);
     if (!buffer) {
-        lv_fs_close(&file);
+        file.close();
         return "";
     }
     
-    uint32_t bytesRead;
-    lv_fs_res_t res = lv_fs_read(&file, buffer, size, &bytesRead);
-    lv_fs_close(&file);
+    size_t bytesRead = file.read((uint8_t*)buffer, size);
+    file.close();
     
-    if (res != LV_FS_RES_OK || bytesRead != size) {
+    if (bytesRead != size) {
         free(buffer);
         return "";
     }
@@ -151,20 +146,15 @@ String readFile(const String& path) {
 }
 
 bool writeFile(const String& path, const String& content) {
-    lv_fs_file_t file;
-    if (lv_fs_open(&file, ("S:" + path).c_str(), LV_FS_MODE_WR) != LV_FS_RES_OK) {
+    File file = SPIFFS.open(path, "w");
+    if (!file) {
         return false;
     }
     
-    uint32_t bytesWritten;
-    lv_fs_res_t res = lv_fs_write(&file, content.c_str(), content.length(), &bytesWritten);
-    lv_fs_close(&file);
-    
-    if (res != LV_FS_RES_OK || bytesWritten != content.length()) {
-        return false;
-    }
+    size_t bytesWritten = file.write((const uint8_t*)content.c_str(), content.length());
+    file.close();
     
-    return true;
+    return bytesWritten == content.length();
 }
 
 bool deleteFile(const String& path) {
@@ -183,53 +173,82 @@ bool deleteStory(const String& filename) {
     return deleteFile("/" + filename);
 }
 
-String getCachedImagePath(const String& url) {
+// SPIFFS names are limited to 31 characters, so paths are keyed by hash.
+static String hashKey(const String& value) {
     uint32_t hash = 0;
-    for (size_t i = 0; i < url.length(); i++) {
-        hash = hash * 31 + url[i];
+    for (size_t i = 0; i < value.length(); i++) {
+        hash = hash * 31 + value[i];
     }
-    return "/cache/img_" + String(hash, HEX) + ".jpg";
+    return String(hash, HEX);
 }
 
-bool isImageCached(const String& url) {
-    String path = getCachedImagePath(url);
+static String cacheKey(const String& url) {
+    return "/cache/img_" + hashKey(url);
+}
+
+// Format-neutral: the decoder sniffs the content, not the suffix.
+String getCachedImagePath(const String& url) {
+    return cacheKey(url) + ".img";
+}
+
+String getTranscodedImagePath(const String& url) {
+    return cacheKey(url) + ".bin";
+}
+
+static bool hasContent(const String& path) {
     if (!exists(path)) {
         return false;
     }
     
     // Check if the cached image actually has content
-    lv_fs_file_t file;
-    if (lv_fs_open(&file, ("S:" + path).c_str(), LV_FS_MODE_RD) != LV_FS_RES_OK) {
+    File file = SPIFFS.open(path, "r");
+    if (!file) {
         return false;
     }
     
-    uint32_t size;
-    lv_fs_seek(&file, 0, LV_FS_SEEK_END);
-    lv_fs_tell(&file, &size);
-    lv_fs_close(&file);
+    size_t size = file.size();
+    file.close();
     
     // Consider cached only if file has content
     return size > 0;
 }
 
+String findCachedImage(const String& url) {
+    String path = getTranscodedImagePath(url);
+    if (hasContent(path)) return path;
+    path = getCachedImagePath(url);
+    if (hasContent(path)) return path;
+    // Downloads from before the cache became format-neutral.
+    path = cacheKey(url) + ".jpg";
+    if (hasContent(path)) return path;
+    return "";
+}
+
+String getThumbnailPath(const String& storyId) {
+    return "/thumb_" + hashKey(storyId) + ".bin";
+}
+
+bool isImageCached(const String& url) {
+    return findCachedImage(url).length() > 0;
+}
+
 bool cacheImage(const String& url, const uint8_t* data, size_t size) {
     String path = getCachedImagePath(url);
     
     Serial.printf("[FILE_SYSTEM] Caching image to: %s (%d bytes)\n", path.c_str(), size);
     
-    lv_fs_file_t file;
-    if (lv_fs_open(&file, ("S:" + path).c_str(), LV_FS_MODE_WR) != LV_FS_RES_OK) {
+    File file = SPIFFS.open(path, "w");
+    if (!file) {
         Serial.printf("[FILE_SYSTEM] Failed to open cache file for writing: %s\n", path.c_str());
         return false;
     }
     
-    uint32_t bytesWritten;
-    lv_fs_res_t res = lv_fs_write(&file, data, size, &bytesWritten);
-    lv_fs_close(&file);
+    size_t bytesWritten = file.write(data, size);
+    file.close();
     
-    if (res != LV_FS_RES_OK || bytesWritten != size) {
-        Serial.printf("[FILE_SYSTEM] Cache write failed: res=%d, written=%d, expected=%d\n", 
-                     res, bytesWritten, size);
+    if (bytesWritten != size) {
+        Serial.printf("[FILE_SYSTEM] Cache write failed: written=%d, expected=%d\n", 
+                     bytesWritten, size);
         return false;
     }
     
@@ -238,6 +257,7 @@ bool cacheImage(const String& url, const uint8_t* data, size_t size) {
 }
 
 bool loadIndex(JsonDocument& doc) {
+    std::lock_guard<std::recursive_mutex> guard(indexLock);
     String content = readFile("/index.json");
     if (content.length() == 0) {
         doc.clear();
@@ -248,6 +268,7 @@ bool loadIndex(JsonDocument& doc) {
 }
 
 bool saveIndex(const JsonDocument& doc) {
+    std::lock_guard<std::recursive_mutex> guard(indexLock);
     String output;
     serializeJson(doc, output);
     return writeFile("/index.json", output);
@@ -274,6 +295,7 @@ bool indexContains(const String& file) {
 }
 
 bool addToIndex(const String& file, const String& name, const String& lang) {
+    std::lock_guard<std::recursive_mutex> guard(indexLock);
     JsonDocument doc;
     if (!loadIndex(doc)) return false;
     
@@ -297,6 +319,7 @@ bool addToIndex(const String& file, const String& name, const String& lang) {
 }
 
 bool removeFromIndex(const String& file) {
+    std::lock_guard<std::recursive_mutex> guard(indexLock);
     JsonDocument doc;
     if (!loadIndex(doc)) return false;
     
@@ -342,6 +365,13 @@ std::vector<String> listFiles(const String& directory) {
     return files;
 }
 
+// Workers download concurrently; read by the perf monitor on the UI task.
+static std::atomic<uint32_t> downloadedBytes(0);
+
+uint32_t takeDownloadedBytes() {
+    return downloadedBytes.exchange(0);
+}
+
 bool httpGet(const String& url, String& response) {
     if (WiFi.status() != WL_CONNECTED) {
         return false;
@@ -355,6 +385,7 @@ bool httpGet(const String& url, String& response) {
     int httpCode = http.GET();
     if (httpCode == HTTP_CODE_OK) {
         response = http.getString();
+        downloadedBytes += response.length();
         http.end();
         return true;
     }
@@ -363,7 +394,7 @@ bool httpGet(const String& url, String& response) {
     return false;
 }
 
-bool downloadFile(const String& url, const String& localPath) {
+bool downloadFile(const String& url, const String& localPath, const std::atomic<bool>* abortFlag) {
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println("[FILE_SYSTEM] WiFi not connected");
         return false;
@@ -390,11 +421,19 @@ bool downloadFile(const String& url, const String& localPath) {
         int totalRead = 0;
         
         while (http.connected() && (len > 0 || len == -1)) {
+            if (abortFlag && abortFlag->load()) {
+                file.close();
+                http.end();
+                SPIFFS.remove(localPath);
+                Serial.println("[FILE_SYSTEM] Download aborted: " + url);
+                return false;
+            }
             size_t size = stream->available();
             if (size) {
                 int c = stream->readBytes(buffer, min(size, sizeof(buffer)));
                 file.write(buffer, c);
                 totalRead += c;
+                downloadedBytes += c;
                 if (len > 0) len -= c;
             }
             delay(1);
@@ -424,7 +463,7 @@ void clearCache() {
 void clearStories() {
     std::vector<String> allFiles = listFiles("/");
     for (const String& filename : allFiles) {
-        if (filename.endsWith(".json") && filename != "index.json") {
+        if ((filename.endsWith(".json") && filename != "index.json") || filename.startsWith("thumb_")) {
             String path = "/" + filename;
             if (deleteFile(path)) {
             }
@@ -4,12 +4,13 @@
 #include <lvgl.h>
 #include <vector>
 #include <ArduinoJson.h>
+#include <atomic>
 
 namespace FileSystem {
 
 bool init();
 
-// File operations using LVGL fs
+// File operations (plain SPIFFS; safe on worker tasks)
 bool exists(const String& path);
 String readFile(const String& path);
 bool writeFile(const String& path, const String& content);
@@ -21,11 +22,19 @@ String loadStory(const String& filename);
 bool deleteStory(const String& filename);
 
 // Image cache operations
+// Download target for the original image.
 String getCachedImagePath(const String& url);
+// Pre-scaled LVGL binary image written after download (IMAGE_CACHE_TRANSCODE).
+String getTranscodedImagePath(const String& url);
+// Transcoded copy if present, else the original, else "".
+String findCachedImage(const String& url);
 bool isImageCached(const String& url);
 bool cacheImage(const String& url, const uint8_t* data, size_t size);
+// Library cover (THUMB_WIDTH x THUMB_HEIGHT LVGL .bin) for an installed story.
+String getThumbnailPath(const String& storyId);
 
-// Index management for stories
+// Index management for stories. Each call is atomic with respect to the
+// others, whichever task makes it.
 bool loadIndex(JsonDocument& doc);
 bool saveIndex(const JsonDocument& doc);
 bool indexContains(const String& file);
@@ -34,7 +43,11 @@ bool removeFromIndex(const String& file);
 
 // HTTP operations
 bool httpGet(const String& url, String& response);
-bool downloadFile(const String& url, const String& localPath);
+// Stops early and removes the partial file when abortFlag becomes true.
+bool downloadFile(const String& url, const String& localPath,
+                  const std::atomic<bool>* abortFlag = nullptr);
+// Bytes received by httpGet() and downloadFile() since the last call.
+uint32_t takeDownloadedBytes();
 
 // Cache management
 void clearCache();
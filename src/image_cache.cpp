@@ -0,0 +1,187 @@
+#include "image_cache.h"
+#include "image_pool.h"
+#include "config.h"
+#include <vector>
+
+namespace ImageCache {
+
+struct Entry {
+    String key;
+    uint16_t* pixels;
+    uint16_t width;
+    uint16_t height;
+    uint16_t refs;
+    uint32_t lastUse;
+    bool complete;
+};
+
+static std::vector<Entry> entries;
+static size_t totalBytes = 0;
+static uint32_t useCounter = 0;
+static uint32_t hits = 0;
+static uint32_t misses = 0;
+
+static size_t entryBytes(const Entry& entry) {
+    return (size_t)entry.width * entry.height * 2;
+}
+
+static void evictAt(size_t index) {
+    Entry& entry = entries[index];
+    totalBytes -= entryBytes(entry);
+    ImagePool::release(entry.pixels);
+    entries.erase(entries.begin() + index);
+}
+
+// Index of the least recently used unreferenced entry, or -1. With
+// heapOnly, entries in a boot slab are skipped.
+static int findVictim(const uint16_t* keep, bool heapOnly = false) {
+    int victim = -1;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].refs > 0 || entries[i].pixels == keep) continue;
+        if (heapOnly && ImagePool::isSlab(entries[i].pixels)) continue;
+        if (victim < 0 || entries[i].lastUse < entries[victim].lastUse) victim = i;
+    }
+    return victim;
+}
+
+static Entry* findEntry(const uint16_t* pixels) {
+    for (Entry& entry : entries) {
+        if (entry.pixels == pixels) return &entry;
+    }
+    return nullptr;
+}
+
+static void enforceBudget(const uint16_t* keep) {
+    while (totalBytes > IMAGE_CACHE_BUDGET) {
+        int victim = findVictim(keep);
+        if (victim < 0) return;
+        evictAt(victim);
+    }
+}
+
+String makeKey(const String& url, uint16_t maxWidth, uint16_t maxHeight) {
+    return url + "#" + String(maxWidth) + "x" + String(maxHeight);
+}
+
+uint16_t* acquire(const String& key, uint16_t& width, uint16_t& height) {
+    for (Entry& entry : entries) {
+        if (entry.complete && entry.key == key) {
+            entry.refs++;
+            entry.lastUse = ++useCounter;
+            width = entry.width;
+            height = entry.height;
+            hits++;
+            return entry.pixels;
+        }
+    }
+    misses++;
+    return nullptr;
+}
+
+bool touch(const String& key) {
+    for (Entry& entry : entries) {
+        if (entry.complete && entry.key == key) {
+            entry.lastUse = ++useCounter;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t* insert(const String& key, ImageDecoder::DecodedImage& image, uint16_t refs,
+                 bool complete) {
+    if (!image.pixels) return nullptr;
+
+    Entry entry;
+    entry.key = key;
+    entry.pixels = image.pixels;
+    entry.width = image.width;
+    entry.height = image.height;
+    entry.refs = refs;
+    entry.lastUse = ++useCounter;
+    entry.complete = complete;
+    image.pixels = nullptr;
+
+    // A racing decode of the same key may already be cached; it stays valid
+    // for its holders and simply ages out.
+    entries.push_back(entry);
+    totalBytes += entryBytes(entry);
+    enforceBudget(entry.pixels);
+
+    if (refs == 0 && totalBytes > IMAGE_CACHE_BUDGET) {
+        evictAt(entries.size() - 1);
+        return nullptr;
+    }
+    return entry.pixels;
+}
+
+void markComplete(uint16_t* pixels) {
+    Entry* entry = findEntry(pixels);
+    if (entry) entry->complete = true;
+}
+
+void discard(uint16_t* pixels) {
+    Entry* entry = findEntry(pixels);
+    if (!entry) return;
+    entry->key = "";
+    entry->complete = false;
+}
+
+void retain(uint16_t* pixels) {
+    Entry* entry = findEntry(pixels);
+    if (entry) entry->refs++;
+}
+
+void release(const uint16_t* pixels) {
+    if (!pixels) return;
+    for (size_t i = 0; i < entries.size(); i++) {
+        Entry& entry = entries[i];
+        if (entry.pixels != pixels) continue;
+
+        if (entry.refs > 0) entry.refs--;
+        if (entry.refs == 0) {
+            if (!entry.complete) {
+                evictAt(i);
+            } else {
+                enforceBudget(nullptr);
+            }
+        }
+        return;
+    }
+    Serial.println("[IMAGE_CACHE] Release of unknown buffer");
+}
+
+bool evictOne() {
+    int victim = findVictim(nullptr);
+    if (victim < 0) return false;
+    evictAt(victim);
+    return true;
+}
+
+void trim() {
+    if (ESP.getFreeHeap() >= IMAGE_CACHE_MIN_FREE_HEAP) return;
+
+    // Evicting a slab-backed image frees no heap; only heap fallbacks and
+    // thumbnails give anything back.
+    size_t before = entries.size();
+    while (ESP.getFreeHeap() < IMAGE_CACHE_MIN_FREE_HEAP) {
+        int victim = findVictim(nullptr, true);
+        if (victim < 0) break;
+        evictAt(victim);
+    }
+    if (entries.size() != before) {
+        Serial.printf("[IMAGE_CACHE] Low heap, evicted %d images (%d bytes cached)\n",
+                      (int)(before - entries.size()), (int)totalBytes);
+    }
+}
+
+Stats stats() {
+    Stats s;
+    s.entries = entries.size();
+    s.bytes = totalBytes;
+    s.hits = hits;
+    s.misses = misses;
+    return s;
+}
+
+}
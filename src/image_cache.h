@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Arduino.h>
+#include "image_decoder.h"
+
+// Decoded RGB565 story images kept in RAM so revisiting a node, or
+// rebuilding the story screen, renders without touching flash. UI thread only.
+// Buffers are reference counted by the canvases showing them; only
+// unreferenced entries are evicted, least recently used first.
+namespace ImageCache {
+
+struct Stats {
+    size_t entries;
+    size_t bytes;
+    uint32_t hits;
+    uint32_t misses;
+};
+
+String makeKey(const String& url, uint16_t maxWidth, uint16_t maxHeight);
+
+// Take a reference to the cached pixels for key, or return nullptr.
+uint16_t* acquire(const String& key, uint16_t& width, uint16_t& height);
+
+// Mark key as recently used without taking a reference; false if absent.
+bool touch(const String& key);
+
+// Take ownership of image.pixels and add `refs` references to the new entry.
+// Older unreferenced entries are evicted to stay within IMAGE_CACHE_BUDGET;
+// with refs == 0 the image itself may not fit, in which case it is freed and
+// nullptr returned. An incomplete entry (still being decoded) is invisible to
+// acquire() and touch() until markComplete().
+uint16_t* insert(const String& key, ImageDecoder::DecodedImage& image, uint16_t refs,
+                 bool complete = true);
+
+void markComplete(uint16_t* pixels);
+
+// Forget a failed entry; its buffer is freed once the last reference goes.
+void discard(uint16_t* pixels);
+
+void retain(uint16_t* pixels);
+
+void release(const uint16_t* pixels);
+
+// Drop the least recently used unreferenced entry; false if there is none.
+bool evictOne();
+
+// Drop unreferenced heap-backed entries while free heap is below
+// IMAGE_CACHE_MIN_FREE_HEAP; slab-backed ones would free nothing.
+void trim();
+
+Stats stats();
+
+}
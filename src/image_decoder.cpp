@@ -0,0 +1,550 @@
+#include "image_decoder.h"
+#include "image_pool.h"
+#include <SPIFFS.h>
+#include <lvgl.h>
+#include <esp32/rom/tjpgd.h>
+
+namespace ImageDecoder {
+
+// Work area required by the ROM TJpgDec.
+static const size_t TJPGD_WORK_SIZE = 3100;
+// Heap left for WiFi and LVGL while a decode is running.
+static const size_t HEAP_RESERVE = 32768;
+// Rows read per chunk when loading a .bin, between cancellation checks.
+static const int BIN_READ_ROWS = 16;
+
+// Blocks arrive from TJpgDec in MCU order; one MCU row is collected in
+// `strip` and then folded row by row into the destination row being averaged.
+struct DecodeContext {
+    File file;
+    const std::atomic<bool>* abortFlag;
+    uint16_t srcWidth;      // after IDCT scaling
+    uint16_t srcHeight;
+    uint16_t dstWidth;
+    uint16_t dstHeight;
+    uint16_t stripHeight;
+    uint8_t* strip;         // RGB888, srcWidth x stripHeight
+    uint16_t* xmap;         // source column -> destination column
+    uint32_t* acc;          // RGB sums for destination row `row`
+    uint16_t* count;        // samples per destination column
+    int row;
+    uint16_t* out;
+    RowCallback onRows;
+    bool published;         // onRows has seen the buffer
+};
+
+static UINT inputFunc(JDEC* jd, BYTE* buf, UINT len) {
+    DecodeContext* ctx = (DecodeContext*)jd->device;
+    if (buf) return ctx->file.read(buf, len);
+    return ctx->file.seek(len, SeekCur) ? len : 0;
+}
+
+static void emitRow(DecodeContext* ctx) {
+    if (ctx->row < 0) return;
+
+    uint16_t* dst = ctx->out + (size_t)ctx->row * ctx->dstWidth;
+    for (int x = 0; x < ctx->dstWidth; x++) {
+        uint32_t n = ctx->count[x];
+        const uint32_t* a = ctx->acc + x * 3;
+        uint32_t r = n ? (a[0] + n / 2) / n : 0;
+        uint32_t g = n ? (a[1] + n / 2) / n : 0;
+        uint32_t b = n ? (a[2] + n / 2) / n : 0;
+        dst[x] = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    }
+    memset(ctx->acc, 0, ctx->dstWidth * 3 * sizeof(uint32_t));
+    memset(ctx->count, 0, ctx->dstWidth * sizeof(uint16_t));
+}
+
+static void filterStrip(DecodeContext* ctx, int top, int rows) {
+    for (int r = 0; r < rows; r++) {
+        int dy = (uint32_t)(top + r) * ctx->dstHeight / ctx->srcHeight;
+        if (dy != ctx->row) {
+            emitRow(ctx);
+            ctx->row = dy;
+        }
+
+        const uint8_t* src = ctx->strip + (size_t)r * ctx->srcWidth * 3;
+        for (int x = 0; x < ctx->srcWidth; x++, src += 3) {
+            uint16_t dx = ctx->xmap[x];
+            uint32_t* a = ctx->acc + dx * 3;
+            a[0] += src[0];
+            a[1] += src[1];
+            a[2] += src[2];
+            ctx->count[dx]++;
+        }
+    }
+
+    // Everything above the row still being accumulated is final.
+    if (ctx->onRows && ctx->row > 0) {
+        ctx->published = true;
+        ctx->onRows(ctx->row);
+    }
+}
+
+static UINT outputFunc(JDEC* jd, void* bitmap, JRECT* rect) {
+    DecodeContext* ctx = (DecodeContext*)jd->device;
+    if (ctx->abortFlag && ctx->abortFlag->load()) return 0;
+    // When the width is not a multiple of the scaled MCU, the last block of
+    // a row can be empty (right = left - 1) or start past the scaled width.
+    // Dropping it leaves exactly one block per MCU row on the right edge.
+    if (rect->right < rect->left || rect->left >= ctx->srcWidth || rect->top >= ctx->srcHeight) {
+        return 1;
+    }
+
+    int stride = (rect->right - rect->left + 1) * 3;
+    int width = stride;
+    if (rect->right >= ctx->srcWidth) width = (ctx->srcWidth - rect->left) * 3;
+    int rows = rect->bottom - rect->top + 1;
+    if (rows > ctx->stripHeight) rows = ctx->stripHeight;
+    if (rect->top + rows > ctx->srcHeight) rows = ctx->srcHeight - rect->top;
+
+    const uint8_t* src = (const uint8_t*)bitmap;
+    for (int y = 0; y < rows; y++, src += stride) {
+        memcpy(ctx->strip + ((size_t)y * ctx->srcWidth + rect->left) * 3, src, width);
+    }
+
+    // The right-most block completes the MCU row; filter it once.
+    if (rect->right + 1 >= ctx->srcWidth) filterStrip(ctx, rect->top, rows);
+    return 1;
+}
+
+static void freeContext(DecodeContext& ctx) {
+    free(ctx.strip);
+    free(ctx.xmap);
+    free(ctx.acc);
+    free(ctx.count);
+    ctx.strip = nullptr;
+    ctx.xmap = nullptr;
+    ctx.acc = nullptr;
+    ctx.count = nullptr;
+    if (ctx.file) ctx.file.close();
+}
+
+// Fit inside the box, keeping the aspect ratio; never upscale.
+static void fitSize(uint32_t width, uint32_t height, uint16_t maxWidth, uint16_t maxHeight,
+                    uint16_t& dstWidth, uint16_t& dstHeight) {
+    dstWidth = width;
+    dstHeight = height;
+    if (width <= maxWidth && height <= maxHeight) return;
+
+    if (width * maxHeight > height * maxWidth) {
+        dstWidth = maxWidth;
+        dstHeight = max<uint32_t>(1, height * maxWidth / width);
+    } else {
+        dstHeight = maxHeight;
+        dstWidth = max<uint32_t>(1, width * maxHeight / height);
+    }
+}
+
+// Allocate the box filter and output buffer once the caller has set the
+// source, strip and destination sizes. decoderBytes is working memory the
+// format decoder already holds; the total is returned for the log. The
+// output comes from ImagePool, so only the small working set is checked
+// against the heap.
+static bool setupFilter(DecodeContext& ctx, DecodedImage& out, size_t decoderBytes, size_t& peakBytes) {
+    size_t stripBytes = (size_t)ctx.srcWidth * ctx.stripHeight * 3;
+    size_t outBytes = (size_t)ctx.dstWidth * ctx.dstHeight * 2;
+    size_t workingBytes = decoderBytes + stripBytes + ctx.srcWidth * sizeof(uint16_t) +
+                          ctx.dstWidth * (3 * sizeof(uint32_t) + sizeof(uint16_t));
+    peakBytes = workingBytes + outBytes;
+
+    size_t freeHeap = ESP.getFreeHeap();
+    if (freeHeap < workingBytes + HEAP_RESERVE) {
+        Serial.printf("[IMAGE_DECODER] ERROR: Insufficient heap memory: %d bytes\n", freeHeap);
+        return false;
+    }
+
+    ctx.strip = (uint8_t*)malloc(stripBytes);
+    ctx.xmap = (uint16_t*)malloc(ctx.srcWidth * sizeof(uint16_t));
+    ctx.acc = (uint32_t*)calloc(ctx.dstWidth * 3, sizeof(uint32_t));
+    ctx.count = (uint16_t*)calloc(ctx.dstWidth, sizeof(uint16_t));
+    ctx.out = ImagePool::alloc(outBytes);
+    if (!ctx.strip || !ctx.xmap || !ctx.acc || !ctx.count || !ctx.out) {
+        Serial.println("[IMAGE_DECODER] ERROR: Failed to allocate image buffer");
+        ImagePool::release(ctx.out);
+        ctx.out = nullptr;
+        return false;
+    }
+    for (int x = 0; x < ctx.srcWidth; x++) {
+        ctx.xmap[x] = (uint32_t)x * ctx.dstWidth / ctx.srcWidth;
+    }
+    if (ctx.onRows) {
+        // Rows not decoded yet show as the white story background.
+        memset(ctx.out, 0xFF, outBytes);
+        out.pixels = ctx.out;
+        out.width = ctx.dstWidth;
+        out.height = ctx.dstHeight;
+    }
+    return true;
+}
+
+// Flush the last row and hand the buffer over, or clean up after a failure.
+static bool finishFilter(DecodeContext& ctx, DecodedImage& out, bool ok) {
+    if (ok) {
+        emitRow(&ctx);
+        if (ctx.onRows) ctx.onRows(ctx.dstHeight);
+        out.pixels = ctx.out;
+        out.width = ctx.dstWidth;
+        out.height = ctx.dstHeight;
+    } else if (!ctx.published) {
+        ImagePool::release(ctx.out);
+        out.pixels = nullptr;
+        out.width = 0;
+        out.height = 0;
+    }
+    freeContext(ctx);
+    return ok;
+}
+
+bool decodeJpegFile(const String& path, uint16_t maxWidth, uint16_t maxHeight, DecodedImage& out,
+                    const std::atomic<bool>* abortFlag, RowCallback onRows) {
+    out.pixels = nullptr;
+    out.width = 0;
+    out.height = 0;
+
+    uint32_t start = millis();
+    DecodeContext ctx = {};
+    ctx.abortFlag = abortFlag;
+    ctx.onRows = onRows;
+    ctx.row = -1;
+    ctx.file = SPIFFS.open(path, "r");
+    if (!ctx.file) {
+        Serial.println("[IMAGE_DECODER] Cannot open " + path);
+        return false;
+    }
+
+    void* work = malloc(TJPGD_WORK_SIZE);
+    if (!work) {
+        Serial.println("[IMAGE_DECODER] ERROR: Failed to allocate decoder work area");
+        freeContext(ctx);
+        return false;
+    }
+
+    JDEC jd;
+    JRESULT res = jd_prepare(&jd, inputFunc, work, TJPGD_WORK_SIZE, &ctx);
+    if (res != JDR_OK) {
+        Serial.printf("[IMAGE_DECODER] Unsupported or corrupt JPEG (%d): %s\n", res, path.c_str());
+        free(work);
+        freeContext(ctx);
+        return false;
+    }
+
+    uint16_t dstWidth, dstHeight;
+    fitSize(jd.width, jd.height, maxWidth, maxHeight, dstWidth, dstHeight);
+
+    // Largest IDCT reduction that still leaves at least the target size.
+    uint8_t scale = 3;
+    while (scale > 0 && ((jd.width >> scale) < dstWidth || (jd.height >> scale) < dstHeight)) {
+        scale--;
+    }
+
+    ctx.srcWidth = jd.width >> scale;
+    ctx.srcHeight = jd.height >> scale;
+    ctx.dstWidth = dstWidth;
+    ctx.dstHeight = dstHeight;
+    ctx.stripHeight = max(1, (jd.msy * 8) >> scale);
+
+    size_t peakBytes;
+    if (!setupFilter(ctx, out, TJPGD_WORK_SIZE, peakBytes)) {
+        free(work);
+        freeContext(ctx);
+        return false;
+    }
+
+    res = jd_decomp(&jd, outputFunc, scale);
+    free(work);
+    if (!finishFilter(ctx, out, res == JDR_OK)) {
+        if (res == JDR_INTR) {
+            Serial.println("[IMAGE_DECODER] Decode cancelled: " + path);
+        } else {
+            Serial.printf("[IMAGE_DECODER] Decode failed (%d): %s\n", res, path.c_str());
+        }
+        return false;
+    }
+
+    Serial.printf("[IMAGE_DECODER] Decoded %s %ux%u -> %ux%u (IDCT 1/%d) in %lu ms, peak %u bytes\n",
+                  path.c_str(), jd.width, jd.height, dstWidth, dstHeight, 1 << scale,
+                  millis() - start, (unsigned)peakBytes);
+    return true;
+}
+
+// QOI (https://qoiformat.org): byte-oriented ops, decoded one row at a time
+// into a single-row strip that feeds the same box filter as the JPEG path.
+static const uint8_t QOI_OP_INDEX = 0x00;
+static const uint8_t QOI_OP_DIFF = 0x40;
+static const uint8_t QOI_OP_LUMA = 0x80;
+static const uint8_t QOI_OP_RUN = 0xC0;
+static const uint8_t QOI_OP_RGB = 0xFE;
+static const uint8_t QOI_OP_RGBA = 0xFF;
+static const uint8_t QOI_MASK_2 = 0xC0;
+static const size_t QOI_HEADER_SIZE = 14;
+static const uint32_t QOI_MAX_DIMENSION = 4096;
+
+struct QoiReader {
+    File* file;
+    uint8_t buf[512];
+    size_t len;
+    size_t pos;
+
+    int next() {
+        if (pos == len) {
+            len = file->read(buf, sizeof(buf));
+            pos = 0;
+            if (len == 0) return -1;
+        }
+        return buf[pos++];
+    }
+};
+
+static uint32_t readBigEndian32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static bool decodeQoiRows(DecodeContext& ctx, uint32_t width, uint32_t height) {
+    QoiReader reader;
+    reader.file = &ctx.file;
+    reader.len = 0;
+    reader.pos = 0;
+
+    uint8_t index[64][4];
+    memset(index, 0, sizeof(index));
+    uint8_t px[4] = {0, 0, 0, 255};
+    int run = 0;
+
+    for (uint32_t y = 0; y < height; y++) {
+        if (ctx.abortFlag && ctx.abortFlag->load()) return false;
+
+        uint8_t* dst = ctx.strip;
+        for (uint32_t x = 0; x < width; x++, dst += 3) {
+            if (run > 0) {
+                run--;
+            } else {
+                int b1 = reader.next();
+                if (b1 < 0) return false;
+
+                if (b1 == QOI_OP_RGB || b1 == QOI_OP_RGBA) {
+                    int channels = (b1 == QOI_OP_RGBA) ? 4 : 3;
+                    for (int c = 0; c < channels; c++) {
+                        int v = reader.next();
+                        if (v < 0) return false;
+                        px[c] = v;
+                    }
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
+                    memcpy(px, index[b1], 4);
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
+                    px[0] += ((b1 >> 4) & 0x03) - 2;
+                    px[1] += ((b1 >> 2) & 0x03) - 2;
+                    px[2] += (b1 & 0x03) - 2;
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
+                    int b2 = reader.next();
+                    if (b2 < 0) return false;
+                    int vg = (b1 & 0x3f) - 32;
+                    px[0] += vg - 8 + ((b2 >> 4) & 0x0f);
+                    px[1] += vg;
+                    px[2] += vg - 8 + (b2 & 0x0f);
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_RUN) {
+                    run = b1 & 0x3f;
+                }
+                memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+            }
+
+            if (px[3] == 255) {
+                dst[0] = px[0];
+                dst[1] = px[1];
+                dst[2] = px[2];
+            } else {
+                // Composite onto the white story background.
+                for (int c = 0; c < 3; c++) {
+                    dst[c] = (px[c] * px[3] + 255 * (255 - px[3]) + 127) / 255;
+                }
+            }
+        }
+        filterStrip(&ctx, y, 1);
+    }
+    return true;
+}
+
+bool decodeQoiFile(const String& path, uint16_t maxWidth, uint16_t maxHeight, DecodedImage& out,
+                   const std::atomic<bool>* abortFlag, RowCallback onRows) {
+    out.pixels = nullptr;
+    out.width = 0;
+    out.height = 0;
+
+    uint32_t start = millis();
+    DecodeContext ctx = {};
+    ctx.abortFlag = abortFlag;
+    ctx.onRows = onRows;
+    ctx.row = -1;
+    ctx.file = SPIFFS.open(path, "r");
+    if (!ctx.file) {
+        Serial.println("[IMAGE_DECODER] Cannot open " + path);
+        return false;
+    }
+
+    uint8_t header[QOI_HEADER_SIZE];
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (ctx.file.read(header, sizeof(header)) == sizeof(header) && memcmp(header, "qoif", 4) == 0) {
+        width = readBigEndian32(header + 4);
+        height = readBigEndian32(header + 8);
+    }
+    if (width == 0 || height == 0 || width > QOI_MAX_DIMENSION || height > QOI_MAX_DIMENSION) {
+        Serial.println("[IMAGE_DECODER] Unsupported or corrupt QOI: " + path);
+        freeContext(ctx);
+        return false;
+    }
+
+    ctx.srcWidth = width;
+    ctx.srcHeight = height;
+    ctx.stripHeight = 1;
+    fitSize(width, height, maxWidth, maxHeight, ctx.dstWidth, ctx.dstHeight);
+
+    size_t peakBytes;
+    if (!setupFilter(ctx, out, sizeof(QoiReader), peakBytes)) {
+        freeContext(ctx);
+        return false;
+    }
+
+    bool cancelled = false;
+    bool ok = decodeQoiRows(ctx, width, height);
+    if (!ok) cancelled = abortFlag && abortFlag->load();
+    if (!finishFilter(ctx, out, ok)) {
+        if (cancelled) {
+            Serial.println("[IMAGE_DECODER] Decode cancelled: " + path);
+        } else {
+            Serial.println("[IMAGE_DECODER] Truncated QOI: " + path);
+        }
+        return false;
+    }
+
+    Serial.printf("[IMAGE_DECODER] Decoded %s %ux%u -> %ux%u (QOI) in %lu ms, peak %u bytes\n",
+                  path.c_str(), width, height, ctx.dstWidth, ctx.dstHeight,
+                  millis() - start, (unsigned)peakBytes);
+    return true;
+}
+
+Format sniffFile(const String& path) {
+    File file = SPIFFS.open(path, "r");
+    if (!file) return FORMAT_UNKNOWN;
+
+    uint8_t magic[4] = {0};
+    size_t len = file.read(magic, sizeof(magic));
+    file.close();
+
+    if (len >= 3 && magic[0] == 0xFF && magic[1] == 0xD8 && magic[2] == 0xFF) return FORMAT_JPEG;
+    if (len == 4 && memcmp(magic, "qoif", 4) == 0) return FORMAT_QOI;
+    return FORMAT_UNKNOWN;
+}
+
+bool decodeFile(const String& path, uint16_t maxWidth, uint16_t maxHeight, DecodedImage& out,
+                const std::atomic<bool>* abortFlag, RowCallback onRows) {
+    switch (sniffFile(path)) {
+        case FORMAT_JPEG:
+            return decodeJpegFile(path, maxWidth, maxHeight, out, abortFlag, onRows);
+        case FORMAT_QOI:
+            return decodeQoiFile(path, maxWidth, maxHeight, out, abortFlag, onRows);
+        default:
+            out.pixels = nullptr;
+            out.width = 0;
+            out.height = 0;
+            Serial.println("[IMAGE_DECODER] Unsupported image format: " + path);
+            return false;
+    }
+}
+
+bool writeBinFile(const String& path, const DecodedImage& image) {
+    if (!image.pixels) return false;
+
+    lv_image_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LV_IMAGE_HEADER_MAGIC;
+    header.cf = LV_COLOR_FORMAT_RGB565;
+    header.w = image.width;
+    header.h = image.height;
+    header.stride = image.width * 2;
+
+    String tmpPath = path + ".tmp";
+    File file = SPIFFS.open(tmpPath, "w");
+    if (!file) {
+        Serial.println("[IMAGE_DECODER] Cannot create " + tmpPath);
+        return false;
+    }
+
+    size_t bytes = (size_t)image.width * image.height * 2;
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write((const uint8_t*)image.pixels, bytes) == bytes;
+    file.close();
+
+    if (ok && SPIFFS.exists(path)) SPIFFS.remove(path);
+    if (!ok || !SPIFFS.rename(tmpPath, path)) {
+        Serial.println("[IMAGE_DECODER] Failed to write " + path);
+        SPIFFS.remove(tmpPath);
+        return false;
+    }
+    return true;
+}
+
+bool readBinFile(const String& path, uint16_t maxWidth, uint16_t maxHeight, DecodedImage& out,
+                 const std::atomic<bool>* abortFlag) {
+    out.pixels = nullptr;
+    out.width = 0;
+    out.height = 0;
+
+    uint32_t start = millis();
+    File file = SPIFFS.open(path, "r");
+    if (!file) {
+        Serial.println("[IMAGE_DECODER] Cannot open " + path);
+        return false;
+    }
+
+    lv_image_header_t header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != LV_IMAGE_HEADER_MAGIC || header.cf != LV_COLOR_FORMAT_RGB565 ||
+        header.w == 0 || header.h == 0 || header.w > maxWidth || header.h > maxHeight ||
+        header.stride != header.w * 2 ||
+        file.size() != sizeof(header) + (size_t)header.stride * header.h) {
+        Serial.println("[IMAGE_DECODER] Invalid cached image: " + path);
+        file.close();
+        return false;
+    }
+
+    uint16_t* pixels = ImagePool::alloc((size_t)header.stride * header.h);
+    if (!pixels) {
+        Serial.println("[IMAGE_DECODER] ERROR: Failed to allocate image buffer");
+        file.close();
+        return false;
+    }
+
+    for (int y = 0; y < header.h; y += BIN_READ_ROWS) {
+        if (abortFlag && abortFlag->load()) {
+            ImagePool::release(pixels);
+            file.close();
+            return false;
+        }
+        int rows = min<int>(BIN_READ_ROWS, header.h - y);
+        size_t bytes = (size_t)header.stride * rows;
+        if (file.read((uint8_t*)(pixels + (size_t)y * header.w), bytes) != bytes) {
+            Serial.println("[IMAGE_DECODER] Short read: " + path);
+            ImagePool::release(pixels);
+            file.close();
+            return false;
+        }
+    }
+    file.close();
+
+    out.pixels = pixels;
+    out.width = header.w;
+    out.height = header.h;
+    Serial.printf("[IMAGE_DECODER] Loaded %s %ux%u in %lu ms\n",
+                  path.c_str(), out.width, out.height, millis() - start);
+    return true;
+}
+
+void release(DecodedImage& image) {
+    if (image.pixels) {
+        ImagePool::release(image.pixels);
+        image.pixels = nullptr;
+    }
+}
+
+}
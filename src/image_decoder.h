@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+
+namespace ImageDecoder {
+
+// RGB565 pixels in native byte order, allocated from ImagePool.
+struct DecodedImage {
+    uint16_t* pixels;
+    uint16_t width;
+    uint16_t height;
+};
+
+// Called on the decoding task once rows [0, rowsDone) of out.pixels are final.
+typedef std::function<void(uint16_t rowsDone)> RowCallback;
+
+// Decode a cached JPEG scaled to fit maxWidth x maxHeight (never upscaled).
+// The IDCT does the coarse 1/2, 1/4 or 1/8 step and a box filter the rest.
+// Touches no LVGL state and keeps all decoder state per call, so it is safe
+// on any worker. Returns false early once abortFlag is set.
+// With onRows, out is filled in (buffer pre-filled white) before the first
+// call so rows can be shown while decoding continues; if the decode then
+// fails, out.pixels is left set and the caller still owns the buffer.
+bool decodeJpegFile(const String& path, uint16_t maxWidth, uint16_t maxHeight, DecodedImage& out,
+                    const std::atomic<bool>* abortFlag = nullptr, RowCallback onRows = nullptr);
+
+// Same contract as decodeJpegFile for a QOI (https://qoiformat.org) file.
+// QOI has no scaled decode, so the box filter does all of the downscaling.
+bool decodeQoiFile(const String& path, uint16_t maxWidth, uint16_t maxHeight, DecodedImage& out,
+                   const std::atomic<bool>* abortFlag = nullptr, RowCallback onRows = nullptr);
+
+enum Format {
+    FORMAT_UNKNOWN,
+    FORMAT_JPEG,
+    FORMAT_QOI
+};
+
+// Identify a file by its magic bytes (reads 4 bytes, not the extension).
+Format sniffFile(const String& path);
+
+// Sniff and dispatch to the matching decoder; other formats are rejected
+// before any decoder memory is allocated.
+bool decodeFile(const String& path, uint16_t maxWidth, uint16_t maxHeight, DecodedImage& out,
+                const std::atomic<bool>* abortFlag = nullptr, RowCallback onRows = nullptr);
+
+// Store an image as an uncompressed RGB565 LVGL binary image (.bin). The
+// file is written under a temporary name and renamed, so a partial write
+// never looks like a valid cache entry.
+bool writeBinFile(const String& path, const DecodedImage& image);
+
+// Load a file written by writeBinFile; rejects anything larger than the box.
+bool readBinFile(const String& path, uint16_t maxWidth, uint16_t maxHeight, DecodedImage& out,
+                 const std::atomic<bool>* abortFlag = nullptr);
+
+void release(DecodedImage& image);
+
+}
@@ -5,10 +5,20 @@
 
 namespace ImageDisplay {
 
-bool displayJpegFromFile(const String& filepath, lv_obj_t* img_obj);
+// Attach a decoded image to img_obj. Takes over one ImageCache reference to
+// pixels, which is released when img_obj is deleted. Cheap: no decode work.
+bool showImage(lv_obj_t* img_obj, uint16_t* pixels, uint16_t width, uint16_t height);
+
+// Redraw rows [from, to) of an image attached with showImage, e.g. after a
+// decoder wrote them into the shared buffer.
+void invalidateRows(lv_obj_t* img_obj, uint16_t from, uint16_t to);
 
 void createLoadingPlaceholder(lv_obj_t* img_obj);
 
+// Load a thumbnail .bin synchronously (a few KB) into a canvas under parent
+// that owns its pixels. Returns nullptr if the file is missing or invalid.
+lv_obj_t* createThumbnail(lv_obj_t* parent, const String& path);
+
 void cleanupImageResources(lv_obj_t* img_obj);
 
 }
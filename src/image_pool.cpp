@@ -0,0 +1,82 @@
+#include "image_pool.h"
+#include "config.h"
+#include <atomic>
+
+namespace ImagePool {
+
+static uint16_t* slabs[IMAGE_SLAB_COUNT] = {nullptr};
+static std::atomic<bool> inUse[IMAGE_SLAB_COUNT];
+static std::atomic<uint32_t> heapFallbacks{0};
+static int reserved = 0;
+
+void init() {
+    if (reserved > 0) return;
+
+    for (int i = 0; i < IMAGE_SLAB_COUNT; i++) {
+        slabs[i] = (uint16_t*)malloc(IMAGE_SLAB_BYTES);
+        if (!slabs[i]) {
+            Serial.printf("[IMAGE_POOL] Only %d of %d slabs reserved\n", i, IMAGE_SLAB_COUNT);
+            break;
+        }
+        inUse[i].store(false);
+        reserved++;
+    }
+    logStats();
+}
+
+uint16_t* alloc(size_t bytes) {
+    if (bytes < IMAGE_SLAB_BYTES / 4) return (uint16_t*)malloc(bytes);
+
+    if (bytes <= IMAGE_SLAB_BYTES) {
+        for (int i = 0; i < reserved; i++) {
+            bool expected = false;
+            if (inUse[i].compare_exchange_strong(expected, true)) return slabs[i];
+        }
+    }
+    heapFallbacks++;
+    Serial.printf("[IMAGE_POOL] Slab unavailable for %d bytes, using heap\n", (int)bytes);
+    return (uint16_t*)malloc(bytes);
+}
+
+void release(void* pixels) {
+    if (!pixels) return;
+    for (int i = 0; i < reserved; i++) {
+        if (slabs[i] == pixels) {
+            inUse[i].store(false);
+            return;
+        }
+    }
+    free(pixels);
+}
+
+bool isSlab(const void* pixels) {
+    for (int i = 0; i < reserved; i++) {
+        if (slabs[i] == pixels) return true;
+    }
+    return false;
+}
+
+int freeSlabs() {
+    int count = 0;
+    for (int i = 0; i < reserved; i++) {
+        if (!inUse[i].load()) count++;
+    }
+    return count;
+}
+
+Stats stats() {
+    Stats s;
+    s.slabs = reserved;
+    s.inUse = reserved - freeSlabs();
+    s.slabBytes = IMAGE_SLAB_BYTES;
+    s.heapFallbacks = heapFallbacks.load();
+    return s;
+}
+
+void logStats() {
+    Stats s = stats();
+    Serial.printf("[IMAGE_POOL] %d/%d slabs in use (%d bytes each), %u heap fallbacks\n",
+                  s.inUse, s.slabs, (int)s.slabBytes, (unsigned)s.heapFallbacks);
+}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Fixed slabs for decoded story images, reserved at boot before the heap
+// fragments. Any task may allocate or release; requests that do not fit a
+// slab, or arrive while all slabs are taken, fall back to the heap. Small
+// images (thumbnails) always use the heap rather than tying up a slab.
+namespace ImagePool {
+
+struct Stats {
+    uint8_t slabs;
+    uint8_t inUse;
+    size_t slabBytes;
+    uint32_t heapFallbacks;
+};
+
+void init();
+
+uint16_t* alloc(size_t bytes);
+
+// Accepts slab and heap buffers alike; nullptr is ignored.
+void release(void* pixels);
+
+// True when pixels is one of the boot slabs; releasing it frees no heap.
+bool isSlab(const void* pixels);
+
+int freeSlabs();
+
+Stats stats();
+
+void logStats();
+
+}
@@ -0,0 +1,157 @@
+#include "library_model.h"
+#include "story_engine.h"
+#include "remote_catalog.h"
+#include "file_system.h"
+#include "async_manager.h"
+#include "story_utils.h"
+#include "i18n.h"
+#include <ArduinoJson.h>
+#include <memory>
+#include <unordered_set>
+
+extern Language current_language;
+
+namespace library
+{
+    typedef std::unordered_set<uint64_t> KeySet;
+
+    // Built by a worker and handed to the UI task in the done callback.
+    struct RefreshJob {
+        std::vector<remote_catalog::Entry> catalog;
+        KeySet installed;
+        int added = 0;
+    };
+
+    static std::vector<Row> g_rows;
+    static KeySet g_installed;
+    static uint32_t g_refresh_seq = 0;
+    static bool g_reload_pending = false;
+
+    // 64-bit FNV-1a; the sets hold a few hundred keys, so collisions are moot.
+    static uint64_t hashOf(const String& s)
+    {
+        uint64_t h = 1469598103934665603ULL;
+        for (size_t i = 0; i < s.length(); ++i) {
+            h ^= (uint8_t)s[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    static String storyPath(const String& file)
+    {
+        if (file.startsWith("/")) return file;
+        return "/" + file;
+    }
+
+    static uint64_t installedKey(const String& file, const String& lang)
+    {
+        return hashOf(storyPath(file) + "|" + lang);
+    }
+
+    // Stories indexed before the index recorded lang carry it only in the file.
+    static String langFromFile(const String& path)
+    {
+        String payload = FileSystem::readFile(path);
+        JsonDocument doc;
+        if (payload.length() == 0 || deserializeJson(doc, payload) != DeserializationError::Ok) {
+            return "";
+        }
+        return doc["lang"] | "";
+    }
+
+    // Worker side: one pass over the index instead of a file read, JSON parse
+    // and index parse per catalog entry.
+    static void buildInstalled(RefreshJob& job)
+    {
+        KeySet indexed;
+        JsonDocument index;
+        if (FileSystem::loadIndex(index)) {
+            for (JsonObjectConst st : index["stories"].as<JsonArrayConst>()) {
+                String path = storyPath(st["file"] | "");
+                if (path.length() <= 1 || !FileSystem::exists(path)) continue;
+                indexed.insert(hashOf(path));
+                String lang = st["lang"] | "";
+                if (lang.length() == 0) lang = langFromFile(path);
+                job.installed.insert(installedKey(path, lang));
+            }
+        }
+
+        for (const auto& ent : job.catalog) {
+            String path = storyPath(ent.file);
+            if (indexed.count(hashOf(path)) || !FileSystem::exists(path)) continue;
+            if (FileSystem::addToIndex(path, ent.name, ent.lang)) {
+                indexed.insert(hashOf(path));
+                job.installed.insert(installedKey(path, ent.lang));
+                ++job.added;
+            }
+        }
+    }
+
+    const std::vector<Row>& rows() { return g_rows; }
+
+    Diff update(bool remote, bool retry)
+    {
+        std::vector<Row> next;
+        const auto& stories = story::all();
+        next.reserve(stories.size());
+        for (size_t i = 0; i < stories.size(); ++i) {
+            next.push_back({ROW_LOCAL, (int)i, hashOf(stories[i].id)});
+        }
+
+        if (remote) {
+            KeySet shown;
+            const auto& ents = remote_catalog::entries();
+            for (size_t i = 0; i < ents.size(); ++i) {
+                const auto& ent = ents[i];
+                if (!story_utils::matchesLanguage(current_language, ent.lang)) continue;
+                uint64_t key = installedKey(ent.file, ent.lang);
+                if (!shown.insert(key).second || g_installed.count(key)) continue;
+                next.push_back({ROW_REMOTE, (int)i, key});
+            }
+        }
+        if (retry) {
+            next.push_back({ROW_RETRY, -1, 0});
+        }
+
+        Diff diff;
+        diff.oldCount = (int)g_rows.size();
+        diff.newCount = (int)next.size();
+        for (int p = 0; p < diff.newCount; ++p) {
+            if (p >= diff.oldCount || g_rows[p] != next[p]) diff.changed.push_back(p);
+        }
+        g_rows.swap(next);
+        return diff;
+    }
+
+    void refresh(RefreshCallback done)
+    {
+        auto job = std::make_shared<RefreshJob>();
+        // The catalog may be invalidated on the UI task while the worker runs.
+        job->catalog = remote_catalog::entries();
+        uint32_t seq = ++g_refresh_seq;
+
+        AsyncManager::runInBackground([job]() { buildInstalled(*job); },
+            [job, seq, done](bool success) {
+                if (!success || seq != g_refresh_seq) return;
+                g_installed.swap(job->installed);
+                if (job->added > 0) {
+                    Serial.printf("[LIBRARY] Indexed %d existing stories\n", job->added);
+                    g_reload_pending = true;
+                }
+                if (done) done(job->added);
+            });
+    }
+
+    void reloadStories()
+    {
+        if (!g_reload_pending) return;
+        g_reload_pending = false;
+        story::loadFromFS();
+    }
+
+    void markInstalled(const String& file, const String& lang)
+    {
+        g_installed.insert(installedKey(file, lang));
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+// View model behind the library list: one row per local story, catalog entry
+// not installed yet, and the retry button. Rows and diffs are computed on the
+// UI task from story::all(), remote_catalog::entries() and a hash set of
+// installed (file, lang) pairs; that set is rebuilt on a worker.
+namespace library {
+  enum RowKind : uint8_t { ROW_LOCAL, ROW_REMOTE, ROW_RETRY };
+
+  // index points into story::all() or remote_catalog::entries(); key
+  // identifies the story, so a row whose index now names another one differs.
+  struct Row {
+    RowKind kind;
+    int index;
+    uint64_t key;
+    bool operator==(const Row& o) const { return kind == o.kind && index == o.index && key == o.key; }
+    bool operator!=(const Row& o) const { return !(*this == o); }
+  };
+
+  // Positions whose row changed, ascending, plus the row count before and after.
+  struct Diff { std::vector<int> changed; int oldCount; int newCount; };
+
+  typedef std::function<void(int added)> RefreshCallback;
+
+  const std::vector<Row>& rows();
+
+  // Recompute the rows; remote rows only when remote is set. Cheap hash
+  // lookups, no file access.
+  Diff update(bool remote, bool retry);
+
+  // Rebuild the installed set from the index on a worker, indexing catalog
+  // files found on SPIFFS but missing from it. done runs on the UI task;
+  // older refreshes still in flight are dropped. story::all() is not
+  // reloaded there, since an open story points into it: when anything was
+  // added, the reload waits for reloadStories().
+  void refresh(RefreshCallback done = nullptr);
+
+  // Reload story::all() if a refresh indexed stories since the last call.
+  // Only call while no story screen is showing.
+  void reloadStories();
+
+  // Record a story just downloaded so its catalog row goes away before the
+  // next refresh.
+  void markInstalled(const String& file, const String& lang);
+}
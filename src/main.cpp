@@ -8,20 +8,26 @@
 #include "i18n.h"
 #include "file_system.h"
 #include "async_manager.h"
+#include "image_pool.h"
+#include "display_driver.h"
 #include "story_engine.h"
 #include "ui/screens/ui_screens.h"
 #include "ui/app_ui.h"
 #include "ui/fonts.h"
 #include "ui/router.h"
+#include "styles.h"
 #include "audio.h"
+#include "perf_monitor.h"
+#include "trace.h"
 
 #if __has_include(<WiFi.h>)
 #include <WiFi.h>
 #endif
 
 SPIClass touchscreenSPI = SPIClass(VSPI);
-XPT2046_Touchscreen touchscreen(XPT2046_CS, XPT2046_IRQ);
-uint32_t draw_buf[DRAW_BUF_SIZE / 4];
+// The IRQ pin is handled here (touch_isr) rather than by the library, so it
+// can also wake the UI loop.
+XPT2046_Touchscreen touchscreen(XPT2046_CS);
 TFT_eSPI tft;
 Preferences prefs;
 uint8_t brightness = 200;
@@ -29,10 +35,33 @@ uint8_t story_font_scale = 1;
 bool online_mode = false;
 bool wifi_connected = false;
 
+static TaskHandle_t ui_task = nullptr;
+static lv_indev_t *touch_indev = nullptr;
+static volatile bool touch_irq = false;
+static bool touch_down = false;
+
+static uint32_t tick_get_cb()
+{
+    return millis();
+}
+
+static void IRAM_ATTR touch_isr()
+{
+    touch_irq = true;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(ui_task, &woken);
+    if (woken)
+        portYIELD_FROM_ISR();
+}
+
 static void touchscreen_read(lv_indev_t *indev, lv_indev_data_t *data)
 {
-    if (touchscreen.tirqTouched() && touchscreen.touched())
+    TRACE_SCOPE("touch_read");
+    // Cleared before sampling so an edge that arrives mid-read is not lost.
+    touch_irq = false;
+    if (touchscreen.touched())
     {
+        touch_down = true;
         TS_Point p = touchscreen.getPoint();
         int16_t rx = p.x;
         int16_t ry = p.y;
@@ -63,10 +92,40 @@ static void touchscreen_read(lv_indev_t *indev, lv_indev_data_t *data)
     }
     else
     {
+        touch_down = false;
         data->state = LV_INDEV_STATE_RELEASED;
     }
 }
 
+#if DISPLAY_BENCHMARK
+// Creation time and heap taken by showing a screen (LVGL allocates from the
+// C heap). Retained screens only pay this on their first visit.
+template <typename F>
+static void benchmark_screen(const char *label, F show, int frames)
+{
+    uint32_t heap = ESP.getFreeHeap();
+    uint32_t start = micros();
+    show();
+    uint32_t built = micros() - start;
+    Serial.printf("[DISPLAY] %s: built in %lu us, %ld bytes of heap\n", label,
+                  (unsigned long)built, (long)heap - (long)ESP.getFreeHeap());
+    DisplayDriver::benchmarkActiveScreen(label, frames);
+}
+
+static void run_display_benchmark()
+{
+    const int frames = 20;
+    benchmark_screen("home", [] { ui_router::show_home(); }, frames);
+    benchmark_screen("library", [] { ui_router::show_library(); }, frames);
+    const auto &stories = story::all();
+    if (!stories.empty())
+    {
+        benchmark_screen("story", [&] { ui_router::show_story(stories[0], stories[0].start); }, frames);
+    }
+    ui_router::show_home();
+}
+#endif
+
 void setup()
 {
     Serial.begin(115200);
@@ -78,19 +137,27 @@ void setup()
     tft.setRotation(0);
     backlight_init();
     lv_init();
+    lv_tick_set_cb(tick_get_cb);
+    ui_task = xTaskGetCurrentTaskHandle();
     
     FileSystem::init();
+    // Before WiFi and LVGL screens fragment the heap.
+    ImagePool::init();
     
     touchscreenSPI.begin(XPT2046_CLK, XPT2046_MISO, XPT2046_MOSI, XPT2046_CS);
     touchscreen.begin(touchscreenSPI);
     touchscreen.setRotation(TOUCH_ROTATION);
     pinMode(XPT2046_IRQ, INPUT_PULLUP);
-    lv_display_t *disp = lv_tft_espi_create(SCREEN_WIDTH, SCREEN_HEIGHT, draw_buf, sizeof(draw_buf));
+    attachInterrupt(digitalPinToInterrupt(XPT2046_IRQ), touch_isr, FALLING);
+    lv_display_t *disp = DisplayDriver::init();
     lv_display_set_default(disp);
-    lv_indev_t *indev = lv_indev_create();
-    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
-    lv_indev_set_display(indev, disp);
-    lv_indev_set_read_cb(indev, touchscreen_read);
+    ui_theme_init(disp);
+    touch_indev = lv_indev_create();
+    lv_indev_set_type(touch_indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_display(touch_indev, disp);
+    lv_indev_set_read_cb(touch_indev, touchscreen_read);
+    // Read from loop() on touch IRQ instead of polling on an LVGL timer.
+    lv_indev_set_mode(touch_indev, LV_INDEV_MODE_EVENT);
 
     audio::init();
     prefs.begin(PNS, false);
@@ -99,6 +166,7 @@ void setup()
     story_font_scale = prefs.getUChar(PK_STORY_FONT, 1);
     online_mode = prefs.getBool(PK_ONLINE_MODE, false);
     backlight_write(brightness);
+    PerfMonitor::init(disp);
 
     ui_router::show_splash(S()->loading);
     for (int i = 0; i < 10; i++) {
@@ -136,15 +204,38 @@ void setup()
     story::loadFromFS();
     ui_story_set_home_cb([]() { ui_router::show_home(); });
     ui_router::show_home();
+#if DISPLAY_BENCHMARK
+    run_display_benchmark();
+#endif
 }
 
 void loop()
 {
-    lv_timer_handler();
-    audio::update();
-    
+    // Everything that touches widgets outside lv_timer_handler() (which
+    // locks itself) holds the LVGL lock.
+    lv_lock();
+    // Results first, so anything they invalidate is drawn by this pass.
     AsyncManager::process();
-    
-    lv_tick_inc(5);
-    delay(5);
+
+    // Keep sampling while the finger is down; there is no IRQ edge for drags.
+    if (touch_irq || touch_down)
+        lv_indev_read(touch_indev);
+    PerfMonitor::pollSerial();
+    lv_unlock();
+
+    uint32_t wait = lv_timer_handler();
+    audio::update();
+
+    // The click sample is paced by update(), so don't sleep mid-playback.
+    if (audio::busy())
+        return;
+    if (touch_down && wait > LV_DEF_REFR_PERIOD)
+        wait = LV_DEF_REFR_PERIOD;
+    if (wait > UI_IDLE_MAX_WAIT_MS)
+        wait = UI_IDLE_MAX_WAIT_MS;
+
+    // Woken early by touch_isr or an AsyncManager worker result.
+    uint32_t sleep_start = micros();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+    PerfMonitor::addIdleTime(micros() - sleep_start);
 }
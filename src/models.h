@@ -8,6 +8,8 @@ struct Choice_t
 {
     String text;
     String next;
+    // Position of next in Story_t::nodes, resolved after parsing; -1 if missing.
+    int next_index = -1;
 };
 
 struct Node_t
@@ -24,13 +26,19 @@ struct Story_t
     String start;
     std::vector<std::pair<String, Node_t>> nodes;
 
-    const Node_t *get(const String &k) const
+    int indexOf(const String &k) const
     {
-        for (const auto &kv : nodes)
+        for (size_t i = 0; i < nodes.size(); ++i)
         {
-            if (kv.first == k)
-                return &kv.second;
+            if (nodes[i].first == k)
+                return (int)i;
         }
-        return nullptr;
+        return -1;
+    }
+
+    const Node_t *get(const String &k) const
+    {
+        int i = indexOf(k);
+        return i < 0 ? nullptr : &nodes[i].second;
     }
 };
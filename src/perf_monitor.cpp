@@ -0,0 +1,200 @@
+#include "perf_monitor.h"
+#include "config.h"
+#include "async_manager.h"
+#include "display_driver.h"
+#include "file_system.h"
+#include "image_cache.h"
+#include "image_pool.h"
+#include "trace.h"
+#include "ui/fonts.h"
+#include <Preferences.h>
+#include <esp_heap_caps.h>
+
+extern Preferences prefs;
+
+namespace PerfMonitor {
+
+static Mode current = PERF_OFF;
+static lv_timer_t* timer = nullptr;
+static lv_obj_t* hud = nullptr;
+static lv_style_t hudStyle;
+
+// Accumulated since the last sample.
+static uint32_t periodStart = 0;
+static uint32_t idleUs = 0;
+static uint32_t frames = 0;
+static uint32_t renderUs = 0;
+static uint32_t renderStart = 0;
+
+static char command[24];
+static size_t commandLen = 0;
+
+// LVGL sends these around each refresh that draws something (not on idle
+// refresh periods), so frames counts real redraws.
+static void renderEventCb(lv_event_t* e) {
+    if (current == PERF_OFF) return;
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        renderStart = micros();
+    } else {
+        renderUs += micros() - renderStart;
+        frames++;
+    }
+}
+
+static void resetPeriod() {
+    periodStart = micros();
+    idleUs = 0;
+    frames = 0;
+    renderUs = 0;
+    DisplayDriver::takeStats();
+    FileSystem::takeDownloadedBytes();
+}
+
+static void sample(lv_timer_t*) {
+    uint32_t now = micros();
+    uint32_t elapsed = now - periodStart;
+    if (elapsed == 0) return;
+
+    uint32_t fps = (uint32_t)((uint64_t)frames * 1000000 / elapsed);
+    uint32_t render = frames ? renderUs / frames : 0;
+    uint32_t idle = (uint32_t)((uint64_t)idleUs * 100 / elapsed);
+    if (idle > 100) idle = 100;
+    DisplayDriver::Stats flush = DisplayDriver::takeStats();
+    uint32_t wait = flush.flushes ? flush.waitUs / flush.flushes : 0;
+
+    uint32_t heap = ESP.getFreeHeap();
+    uint32_t minHeap = ESP.getMinFreeHeap();
+    uint32_t block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    ImagePool::Stats pool = ImagePool::stats();
+
+    int queued[AsyncManager::PRIORITY_COUNT];
+    int running = 0;
+    for (int p = 0; p < AsyncManager::PRIORITY_COUNT; p++) {
+        queued[p] = AsyncManager::pendingCount((AsyncManager::Priority)p);
+        running += AsyncManager::runningCount((AsyncManager::Priority)p);
+    }
+
+    ImageCache::Stats cache = ImageCache::stats();
+    uint32_t lookups = cache.hits + cache.misses;
+    uint32_t hitRate = lookups ? cache.hits * 100 / lookups : 0;
+    uint32_t download = (uint32_t)((uint64_t)FileSystem::takeDownloadedBytes() * 1000000 / elapsed);
+
+    // One line per period, key=value so it can be grepped or split in a script.
+    Serial.printf("[PERF] fps=%lu render=%luus wait=%luus idle=%lu%% heap=%lu min=%lu blk=%lu "
+                  "slabs=%u/%u fb=%lu q=%d/%d/%d/%d run=%d hit=%lu%% dl=%luB/s\n",
+                  (unsigned long)fps, (unsigned long)render, (unsigned long)wait,
+                  (unsigned long)idle, (unsigned long)heap, (unsigned long)minHeap,
+                  (unsigned long)block, pool.inUse, pool.slabs,
+                  (unsigned long)pool.heapFallbacks, queued[0], queued[1], queued[2],
+                  queued[3], running, (unsigned long)hitRate, (unsigned long)download);
+
+    if (hud) {
+        lv_label_set_text_fmt(hud,
+                              "%lu fps  %lu us  idle %lu%%\n"
+                              "heap %luK  blk %luK  slab %u/%u\n"
+                              "q %d/%d/%d/%d  run %d  hit %lu%%\n"
+                              "dl %lu B/s",
+                              (unsigned long)fps, (unsigned long)render, (unsigned long)idle,
+                              (unsigned long)(heap / 1024), (unsigned long)(block / 1024),
+                              pool.inUse, pool.slabs, queued[0], queued[1], queued[2],
+                              queued[3], running, (unsigned long)hitRate,
+                              (unsigned long)download);
+    }
+
+    resetPeriod();
+}
+
+static void createHud() {
+    if (hud) return;
+    static bool styled = false;
+    if (!styled) {
+        lv_style_init(&hudStyle);
+        lv_style_set_bg_color(&hudStyle, lv_color_black());
+        lv_style_set_bg_opa(&hudStyle, LV_OPA_70);
+        lv_style_set_text_color(&hudStyle, lv_color_white());
+        lv_style_set_text_font(&hudStyle, font12());
+        lv_style_set_pad_all(&hudStyle, 2);
+        styled = true;
+    }
+    // The top layer stays above every screen and is not clickable, so the
+    // HUD never steals touches.
+    hud = lv_label_create(lv_layer_top());
+    lv_obj_add_style(hud, &hudStyle, 0);
+    lv_obj_align(hud, LV_ALIGN_BOTTOM_MID, 0, -56);
+    lv_label_set_text(hud, "");
+}
+
+void init(lv_display_t* disp) {
+    lv_display_add_event_cb(disp, renderEventCb, LV_EVENT_RENDER_START, nullptr);
+    lv_display_add_event_cb(disp, renderEventCb, LV_EVENT_RENDER_READY, nullptr);
+    timer = lv_timer_create(sample, PERF_MONITOR_PERIOD_MS, nullptr);
+    lv_timer_pause(timer);
+
+    uint8_t saved = prefs.getUChar(PK_PERF_MODE, PERF_OFF);
+    setMode(saved <= PERF_HUD ? (Mode)saved : PERF_OFF);
+}
+
+void setMode(Mode mode) {
+    if (mode != PERF_HUD && hud) {
+        lv_obj_delete(hud);
+        hud = nullptr;
+    }
+    if (mode == PERF_HUD) createHud();
+
+    if (mode == PERF_OFF) {
+        // A paused timer does not shorten lv_timer_handler()'s sleep hint.
+        lv_timer_pause(timer);
+    } else if (current == PERF_OFF) {
+        resetPeriod();
+        lv_timer_resume(timer);
+    }
+
+    if (mode != current) {
+        current = mode;
+        prefs.putUChar(PK_PERF_MODE, mode);
+        Serial.printf("[PERF] mode %s\n", mode == PERF_HUD ? "hud" : mode == PERF_LOG ? "log" : "off");
+    }
+}
+
+Mode mode() {
+    return current;
+}
+
+void addIdleTime(uint32_t us) {
+    if (current != PERF_OFF) idleUs += us;
+}
+
+static void runCommand(const char* cmd) {
+#if TRACE_ENABLE
+    if (strcmp(cmd, "trace arm") == 0) {
+        Trace::arm();
+        return;
+    }
+    if (strcmp(cmd, "trace dump") == 0) {
+        Trace::dump();
+        return;
+    }
+#endif
+    if (strncmp(cmd, "perf", 4) != 0) return;
+    const char* arg = cmd + 4;
+    while (*arg == ' ') arg++;
+    if (strcmp(arg, "off") == 0) setMode(PERF_OFF);
+    else if (strcmp(arg, "log") == 0) setMode(PERF_LOG);
+    else if (strcmp(arg, "hud") == 0) setMode(PERF_HUD);
+    else Serial.println("[PERF] usage: perf off|log|hud");
+}
+
+void pollSerial() {
+    while (Serial.available()) {
+        int c = Serial.read();
+        if (c == '\n' || c == '\r') {
+            command[commandLen] = '\0';
+            if (commandLen) runCommand(command);
+            commandLen = 0;
+        } else if (commandLen < sizeof(command) - 1) {
+            command[commandLen++] = (char)c;
+        }
+    }
+}
+
+}
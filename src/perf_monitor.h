@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// Runtime performance telemetry, switchable without a special build. Every
+// PERF_MONITOR_PERIOD_MS it samples rendering, heap, the async queues, the
+// image cache and downloads, and prints one "[PERF]" line; in PERF_HUD mode
+// the same figures are also shown on the top layer. UI thread only.
+//
+// Serial commands (newline terminated): "perf off", "perf log", "perf hud",
+// and in TRACE_ENABLE builds "trace arm" and "trace dump" (trace.h).
+// The mode is kept in Preferences so it survives a reboot in the field.
+namespace PerfMonitor {
+
+enum Mode : uint8_t {
+    PERF_OFF = 0,
+    PERF_LOG,
+    PERF_HUD,
+};
+
+// Hook the display's render events and start in the saved mode.
+void init(lv_display_t* disp);
+
+void setMode(Mode mode);
+
+Mode mode();
+
+// Time the UI loop spent asleep waiting for work; the idle figure is its
+// share of each sample period.
+void addIdleTime(uint32_t us);
+
+// Read serial commands; call from loop().
+void pollSerial();
+
+}
@@ -5,7 +5,10 @@
 #include <ArduinoJson.h>
 #include "i18n.h"
 #include "story_utils.h"
+#include "kiddo_parser.h"
+#include "image_decoder.h"
 #include <Preferences.h>
+#include <SPIFFS.h>
 #include <WiFi.h>
 
 extern Preferences prefs;
@@ -96,6 +99,7 @@ static bool indexContainsFile(const JsonDocument& doc, const String& file) {
             e.file = f;
             e.name = n;
             e.lang = lang;
+            e.cover = o["cover"] | "";
             
             if (e.name.length() == 0) {
                 e.name = e.file;
@@ -115,6 +119,72 @@ static bool indexContainsFile(const JsonDocument& doc, const String& file) {
         return true;
     }
 
+    // The catalog's cover if it has one, else the first image of the start node,
+    // else the first image anywhere in the story.
+    static String thumbnailSource(const JsonDocument& doc, const String& cover, bool& isCover)
+    {
+        isCover = cover.length() > 0;
+        if (isCover) {
+            return cover.startsWith("http") ? cover : basePathFromCatalog() + cover;
+        }
+
+        JsonObjectConst nodes = doc["nodes"];
+        const char* start = doc["start"] | "";
+        std::vector<String> urls = KiddoParser::getImageUrls(nodes[start]["text"] | "");
+        if (!urls.empty()) return urls[0];
+
+        for (JsonPairConst kv : nodes) {
+            urls = KiddoParser::getImageUrls(kv.value()["text"] | "");
+            if (!urls.empty()) return urls[0];
+        }
+        return "";
+    }
+
+    // Runs on the download worker, so the one-off decode never touches the UI.
+    // The image is fetched to a private name: an image job may be writing or
+    // reading the cache file for the same URL meanwhile. A story image is
+    // then moved into the cache for the first read unless a job got there
+    // first; anything else fetched just for the thumbnail is deleted.
+    static void ensureThumbnail(const String& payload, const String& cover)
+    {
+        JsonDocument doc;
+        if (deserializeJson(doc, payload) != DeserializationError::Ok) return;
+
+        String storyId = doc["id"] | "";
+        if (storyId.length() == 0) return;
+        String thumbPath = FileSystem::getThumbnailPath(storyId);
+        if (FileSystem::exists(thumbPath)) return;
+
+        bool isCover = false;
+        String url = thumbnailSource(doc, cover, isCover);
+        if (url.length() == 0) return;
+
+        // A transcoded copy is already scaled to the story box; go back to
+        // the original rather than scale twice.
+        String cached = FileSystem::findCachedImage(url);
+        String source = cached;
+        bool downloaded = false;
+        if (cached.length() == 0 || cached.endsWith(".bin")) {
+            source = FileSystem::getCachedImagePath(url) + ".thumb";
+            if (!FileSystem::downloadFile(url, source)) return;
+            downloaded = true;
+        }
+
+        ImageDecoder::DecodedImage thumb = {nullptr, 0, 0};
+        if (ImageDecoder::decodeFile(source, THUMB_WIDTH, THUMB_HEIGHT, thumb)) {
+            ImageDecoder::writeBinFile(thumbPath, thumb);
+            ImageDecoder::release(thumb);
+        }
+
+        if (!downloaded) return;
+        // SPIFFS refuses to rename over an existing file.
+        String target = FileSystem::getCachedImagePath(url);
+        if (isCover || cached.length() > 0 || FileSystem::exists(target) ||
+            !SPIFFS.rename(source, target)) {
+            FileSystem::deleteFile(source);
+        }
+    }
+
     const std::vector<Entry> &entries() { return g_entries; }
     bool last_ok() { return g_last_ok; }
     void invalidate()
@@ -159,7 +229,7 @@ static bool indexContainsFile(const JsonDocument& doc, const String& file) {
                 String lang = entryFound ? foundEntry.lang : "";
                 FileSystem::addToIndex(localPath, name, lang);
             }
-            story::loadFromFS();
+            ensureThumbnail(FileSystem::readFile(localPath), entryFound ? foundEntry.cover : "");
             return true;
         }
         
@@ -199,32 +269,10 @@ static bool indexContainsFile(const JsonDocument& doc, const String& file) {
             return false;
         }
         
-        story::loadFromFS();
+        ensureThumbnail(payload, entryFound ? foundEntry.cover : "");
         return true;
     }
 
-    int reconcileExisting()
-    {
-        int added = 0;
-        bool any = false;
-        
-        for (const auto &ent : g_entries) {
-            String localPath = "/" + ent.file;
-            if (FileSystem::exists(localPath) && !FileSystem::indexContains(localPath)) {
-                if (FileSystem::addToIndex(localPath, ent.name, ent.lang)) {
-                    ++added;
-                    any = true;
-                }
-            }
-        }
-        
-        if (any) {
-            story::loadFromFS();
-        }
-        
-        return added;
-    }
-
     int clearDownloads()
     {
         FileSystem::clearStories();
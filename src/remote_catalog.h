@@ -3,7 +3,8 @@
 #include <vector>
 
 namespace remote_catalog {
-  struct Entry { String file; String name; String lang; };
+  // cover is an optional image URL (absolute, or relative to the catalog).
+  struct Entry { String file; String name; String lang; String cover; };
 
   String getCatalogUrl();
 
@@ -17,8 +18,7 @@ namespace remote_catalog {
 
   void invalidate();
 
-  int reconcileExisting();
-
+  // Runs on an AsyncManager worker; the caller reloads story::all() on the UI task.
   bool ensureDownloadedOrIndexed(const String& file, String* outStoryId = nullptr);
   
   int clearDownloads();
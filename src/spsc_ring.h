@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Bounded lock-free ring for exactly one producer task and one consumer
+// task. Items are moved in and out, never byte-copied, so types with
+// non-trivial members are safe. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (leaving item untouched) when full.
+    bool push(T&& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity) return false;
+        slots_[tail & (Capacity - 1)] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when empty.
+    bool pop(T& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head) return false;
+        out = std::move(slots_[head & (Capacity - 1)]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called from a third task.
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    T slots_[Capacity];
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
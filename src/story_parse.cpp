@@ -36,6 +36,11 @@ namespace story
             }
             out.nodes.push_back({key, nn});
         }
+        for (auto &kv : out.nodes)
+        {
+            for (auto &ch : kv.second.choices)
+                ch.next_index = out.indexOf(ch.next);
+        }
         return true;
     }
 }
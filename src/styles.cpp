@@ -0,0 +1,179 @@
+#include "styles.h"
+#include "ui/fonts.h"
+
+lv_style_t style_btn_primary;
+lv_style_t style_btn_primary_pressed;
+lv_style_t style_btn_secondary;
+lv_style_t style_btn_secondary_pressed;
+lv_style_t style_compact;
+lv_style_t style_plain;
+lv_style_t style_screen_bg;
+lv_style_t style_header;
+lv_style_t style_header_title;
+lv_style_t style_story_text;
+lv_style_t style_story_image;
+lv_style_t style_choice_panel;
+lv_style_t style_choice_btn;
+lv_style_t style_toast;
+lv_style_t style_toast_text;
+lv_style_t style_overlay;
+lv_style_t style_overlay_box;
+
+static lv_style_t style_spinner;
+static lv_style_t style_spinner_indicator;
+static bool styles_inited = false;
+
+static const uint32_t COLOR_SAND = 0xe9d4a9;
+
+static void init_button_style(lv_style_t* s, lv_color_t bg, lv_color_t text){
+  lv_style_init(s);
+  lv_style_set_bg_color(s, bg);
+  lv_style_set_bg_opa(s, LV_OPA_COVER);
+  lv_style_set_radius(s, 10);
+  lv_style_set_border_width(s, 0);
+  lv_style_set_pad_left(s, 10);
+  lv_style_set_pad_right(s, 10);
+  lv_style_set_pad_top(s, 6);
+  lv_style_set_pad_bottom(s, 6);
+  lv_style_set_text_color(s, text);
+}
+
+void ensure_styles(){
+  if(styles_inited) return;
+  styles_inited = true;
+  init_button_style(&style_btn_primary, lv_palette_main(LV_PALETTE_ORANGE), lv_color_white());
+  lv_style_init(&style_btn_primary_pressed);
+  lv_style_set_bg_color(&style_btn_primary_pressed, lv_palette_darken(LV_PALETTE_ORANGE, 1));
+  // secondary
+  init_button_style(&style_btn_secondary, lv_palette_lighten(LV_PALETTE_GREY, 2), lv_color_black());
+  lv_style_init(&style_btn_secondary_pressed);
+  lv_style_set_bg_color(&style_btn_secondary_pressed, lv_palette_main(LV_PALETTE_GREY));
+
+  lv_style_init(&style_compact);
+  lv_style_set_pad_all(&style_compact, 0);
+  lv_style_set_pad_hor(&style_compact, 0);
+  lv_style_set_pad_ver(&style_compact, 0);
+  lv_style_set_pad_row(&style_compact, 0);
+  lv_style_set_pad_column(&style_compact, 2);
+  lv_style_set_margin_all(&style_compact, 0);
+  lv_style_set_text_line_space(&style_compact, 0);
+  lv_style_set_bg_opa(&style_compact, LV_OPA_TRANSP);
+
+  // Layout-only containers: no background, border or padding.
+  lv_style_init(&style_plain);
+  lv_style_set_bg_opa(&style_plain, LV_OPA_TRANSP);
+  lv_style_set_border_width(&style_plain, 0);
+  lv_style_set_pad_all(&style_plain, 0);
+
+  lv_style_init(&style_screen_bg);
+  lv_style_set_bg_color(&style_screen_bg, lv_color_hex(0x4c8cb9));
+  lv_style_set_bg_grad_color(&style_screen_bg, lv_color_hex(0xa6cdec));
+  lv_style_set_bg_grad_dir(&style_screen_bg, LV_GRAD_DIR_VER);
+  lv_style_set_bg_opa(&style_screen_bg, LV_OPA_COVER);
+
+  lv_style_init(&style_header);
+  lv_style_set_bg_color(&style_header, lv_color_hex(COLOR_SAND));
+  lv_style_set_bg_opa(&style_header, LV_OPA_COVER);
+  lv_style_set_border_width(&style_header, 0);
+  lv_style_set_radius(&style_header, 0);
+  lv_style_set_pad_left(&style_header, 6);
+  lv_style_set_pad_right(&style_header, 6);
+
+  lv_style_init(&style_header_title);
+  lv_style_set_text_font(&style_header_title, font16());
+  lv_style_set_text_color(&style_header_title, lv_color_black());
+
+  // Set on the story content column; text and choice labels inherit it.
+  lv_style_init(&style_story_text);
+  lv_style_set_text_font(&style_story_text, font16());
+  lv_style_set_text_color(&style_story_text, lv_color_black());
+
+  lv_style_init(&style_story_image);
+  lv_style_set_pad_top(&style_story_image, 3);
+  lv_style_set_pad_bottom(&style_story_image, 6);
+
+  lv_style_init(&style_choice_panel);
+  lv_style_set_bg_color(&style_choice_panel, lv_color_hex(COLOR_SAND));
+  lv_style_set_bg_opa(&style_choice_panel, LV_OPA_COVER);
+  lv_style_set_pad_all(&style_choice_panel, 6);
+  lv_style_set_pad_row(&style_choice_panel, 6);
+
+  lv_style_init(&style_choice_btn);
+  lv_style_set_width(&style_choice_btn, LV_PCT(100));
+  lv_style_set_min_height(&style_choice_btn, 34);
+
+  lv_style_init(&style_toast);
+  lv_style_set_bg_color(&style_toast, lv_palette_main(LV_PALETTE_GREEN));
+  lv_style_set_bg_opa(&style_toast, LV_OPA_COVER);
+  lv_style_set_border_width(&style_toast, 0);
+  lv_style_set_pad_all(&style_toast, 16);
+  lv_style_set_radius(&style_toast, 0);
+
+  lv_style_init(&style_toast_text);
+  lv_style_set_text_color(&style_toast_text, lv_color_white());
+  lv_style_set_text_align(&style_toast_text, LV_TEXT_ALIGN_CENTER);
+
+  lv_style_init(&style_overlay);
+  lv_style_set_bg_color(&style_overlay, lv_color_black());
+  lv_style_set_bg_opa(&style_overlay, LV_OPA_50);
+
+  lv_style_init(&style_overlay_box);
+  lv_style_set_bg_opa(&style_overlay_box, LV_OPA_COVER);
+  lv_style_set_radius(&style_overlay_box, 12);
+  lv_style_set_pad_all(&style_overlay_box, 8);
+
+  lv_style_init(&style_spinner);
+  lv_style_set_arc_color(&style_spinner, lv_color_hex(0x666666));
+  lv_style_init(&style_spinner_indicator);
+  lv_style_set_arc_color(&style_spinner_indicator, lv_color_hex(0x2196F3));
+}
+
+// Runs after the default theme for every new object.
+static void theme_apply_cb(lv_theme_t* th, lv_obj_t* obj){
+  LV_UNUSED(th);
+  if(lv_obj_check_type(obj, &lv_spinner_class)){
+    lv_obj_add_style(obj, &style_spinner, LV_PART_MAIN);
+    lv_obj_add_style(obj, &style_spinner_indicator, LV_PART_INDICATOR);
+  }
+}
+
+void ui_theme_init(lv_display_t* disp){
+  ensure_styles();
+  // Same colors lv_display_create() picks; only the font changes.
+  lv_theme_t* base = lv_theme_default_init(disp, lv_palette_main(LV_PALETTE_BLUE),
+                                           lv_palette_main(LV_PALETTE_RED), false, font14());
+  static lv_theme_t* theme = nullptr;
+  if(!theme){
+    theme = lv_theme_create();
+    lv_theme_copy(theme, base);
+    lv_theme_set_parent(theme, base);
+    lv_theme_set_apply_cb(theme, theme_apply_cb);
+  }
+  lv_display_set_theme(disp, theme);
+}
+
+void set_story_text_font(const lv_font_t* font){
+  static const lv_font_t* current = nullptr;
+  ensure_styles();
+  if(font == current) return;
+  current = font;
+  lv_style_set_text_font(&style_story_text, font);
+  lv_obj_report_style_change(&style_story_text);
+}
+
+void apply_primary_button_style(lv_obj_t* btn){
+  ensure_styles();
+  lv_obj_add_style(btn, &style_btn_primary, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_add_style(btn, &style_btn_primary_pressed, LV_PART_MAIN | LV_STATE_PRESSED);
+}
+
+void apply_secondary_button_style(lv_obj_t* btn){
+  ensure_styles();
+  lv_obj_add_style(btn, &style_btn_secondary, LV_PART_MAIN | LV_STATE_DEFAULT);
+  lv_obj_add_style(btn, &style_btn_secondary_pressed, LV_PART_MAIN | LV_STATE_PRESSED);
+}
+
+void apply_screen_bg(lv_obj_t* obj){
+  ensure_styles();
+  lv_obj_add_style(obj, &style_screen_bg, 0);
+}
@@ -1,69 +1,44 @@
 #pragma once
 #include <lvgl.h>
 
-// Minimal primary button style helpers
-static lv_style_t style_btn_primary;
-static lv_style_t style_btn_secondary;
-static bool styles_inited = false;
-static lv_style_t style_compact;
-static bool compact_inited = false;
+// Shared styles, defined once in styles.cpp and initialized by ensure_styles()
+// (ui_theme_init() calls it at startup). An added style costs the object one
+// pointer; every lv_obj_set_style_* call allocates a local style entry instead.
+extern lv_style_t style_btn_primary;
+extern lv_style_t style_btn_primary_pressed;
+extern lv_style_t style_btn_secondary;
+extern lv_style_t style_btn_secondary_pressed;
+extern lv_style_t style_compact;
+extern lv_style_t style_plain;
+extern lv_style_t style_screen_bg;
+extern lv_style_t style_header;
+extern lv_style_t style_header_title;
+extern lv_style_t style_story_text;
+extern lv_style_t style_story_image;
+extern lv_style_t style_choice_panel;
+extern lv_style_t style_choice_btn;
+extern lv_style_t style_toast;
+extern lv_style_t style_toast_text;
+extern lv_style_t style_overlay;
+extern lv_style_t style_overlay_box;
 
-inline void ensure_styles(){
-  if(styles_inited) return;
-  styles_inited = true;
-  lv_style_init(&style_btn_primary);
-  lv_style_set_bg_color(&style_btn_primary, lv_palette_main(LV_PALETTE_ORANGE));
-  lv_style_set_bg_opa(&style_btn_primary, LV_OPA_COVER);
-  lv_style_set_radius(&style_btn_primary, 10);
-  lv_style_set_border_width(&style_btn_primary, 0);
-  lv_style_set_pad_left(&style_btn_primary, 10);
-  lv_style_set_pad_right(&style_btn_primary, 10);
-  lv_style_set_pad_top(&style_btn_primary, 6);
-  lv_style_set_pad_bottom(&style_btn_primary, 6);
-  lv_style_set_text_color(&style_btn_primary, lv_color_white());
-  // secondary
-  lv_style_init(&style_btn_secondary);
-  lv_style_set_bg_color(&style_btn_secondary, lv_palette_lighten(LV_PALETTE_GREY,2));
-  lv_style_set_bg_opa(&style_btn_secondary, LV_OPA_COVER);
-  lv_style_set_radius(&style_btn_secondary, 10);
-  lv_style_set_border_width(&style_btn_secondary, 0);
-  lv_style_set_pad_left(&style_btn_secondary, 10);
-  lv_style_set_pad_right(&style_btn_secondary, 10);
-  lv_style_set_pad_top(&style_btn_secondary, 6);
-  lv_style_set_pad_bottom(&style_btn_secondary, 6);
-  lv_style_set_text_color(&style_btn_secondary, lv_color_black());
-}
+void ensure_styles();
 
-inline void apply_primary_button_style(lv_obj_t* btn){
-  ensure_styles();
-  lv_obj_add_style(btn, &style_btn_primary, LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_bg_color(btn, lv_palette_darken(LV_PALETTE_ORANGE, 1), LV_PART_MAIN | LV_STATE_PRESSED);
-}
+// LVGL's default theme with font14() as the normal font (labels inherit it
+// from the screen), extended with the shared spinner style. The theme only
+// sees an object's class, at creation: headers, toasts, overlays and list
+// rows are plain lv_obj and buttons come as primary, secondary or dialog
+// buttons with local styles, so those keep getting their shared style from
+// the component that creates them.
+void ui_theme_init(lv_display_t* disp);
 
-inline void apply_secondary_button_style(lv_obj_t* btn){
-  ensure_styles();
-  lv_obj_add_style(btn, &style_btn_secondary, LV_PART_MAIN | LV_STATE_DEFAULT);
-  lv_obj_set_style_bg_color(btn, lv_palette_main(LV_PALETTE_GREY), LV_PART_MAIN | LV_STATE_PRESSED);
-}
+// The story body font follows the font-scale setting; changing it refreshes
+// every object using style_story_text.
+void set_story_text_font(const lv_font_t* font);
 
-inline void ensure_compact_style(){
-  if(compact_inited) return;
-  compact_inited = true;
-  lv_style_init(&style_compact);
-  lv_style_set_pad_all(&style_compact, 0);
-  lv_style_set_pad_hor(&style_compact, 0);
-  lv_style_set_pad_ver(&style_compact, 0);
-  lv_style_set_pad_row(&style_compact, 0);
-  lv_style_set_pad_column(&style_compact, 2);
-  lv_style_set_margin_all(&style_compact, 0);
-  lv_style_set_text_line_space(&style_compact, 0);
-  lv_style_set_bg_opa(&style_compact, LV_OPA_TRANSP);
-}
+// Minimal primary button style helpers
+void apply_primary_button_style(lv_obj_t* btn);
+void apply_secondary_button_style(lv_obj_t* btn);
 
 // Screen background gradient helper
-inline void apply_screen_bg(lv_obj_t* obj){
-  lv_obj_set_style_bg_color(obj, lv_color_hex(0x4c8cb9), 0);
-  lv_obj_set_style_bg_grad_color(obj, lv_color_hex(0xa6cdec), 0);
-  lv_obj_set_style_bg_grad_dir(obj, LV_GRAD_DIR_VER, 0);
-  lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
-}
+void apply_screen_bg(lv_obj_t* obj);
@@ -0,0 +1,107 @@
+#include "trace.h"
+
+#if TRACE_ENABLE
+
+#include <Arduino.h>
+#include "config.h"
+#include <atomic>
+#include <esp_timer.h>
+
+namespace Trace {
+
+struct Event {
+    const char* name;
+    uint32_t ts;
+    TaskHandle_t task;
+    char phase;
+};
+
+static Event events[TRACE_BUF_EVENTS];
+// Written from every task on both cores; each writer claims its own slot.
+static std::atomic<uint32_t> head(0);
+static std::atomic<bool> recording(true);
+static bool oneShot = false;
+
+static void record(const char* name, char phase) {
+    if (!recording.load(std::memory_order_relaxed)) return;
+    uint32_t i = head.fetch_add(1, std::memory_order_relaxed);
+    if (oneShot && i >= TRACE_BUF_EVENTS) {
+        recording.store(false);
+        return;
+    }
+    Event& e = events[i % TRACE_BUF_EVENTS];
+    e.name = name;
+    e.ts = (uint32_t)esp_timer_get_time();
+    e.task = xTaskGetCurrentTaskHandle();
+    e.phase = phase;
+}
+
+static void restart(bool stopWhenFull) {
+    recording.store(false);
+    // Let a writer on the other core finish the slot it claimed.
+    delay(2);
+    head.store(0);
+    oneShot = stopWhenFull;
+    recording.store(true);
+}
+
+void arm() {
+    restart(true);
+    Serial.printf("[TRACE] armed, %d events\n", TRACE_BUF_EVENTS);
+}
+
+void dump() {
+    recording.store(false);
+    delay(2);
+
+    // head keeps counting past the end in one-shot mode, but only the first
+    // TRACE_BUF_EVENTS slots were written; otherwise the newest ones survive.
+    uint32_t total = head.load();
+    uint32_t count = total < TRACE_BUF_EVENTS ? total : TRACE_BUF_EVENTS;
+    uint32_t first = oneShot ? 0 : total - count;
+
+    // Chrome wants small thread ids; map the task handles seen to 1..n.
+    TaskHandle_t tasks[16];
+    int taskCount = 0;
+    // Slots are claimed before they are stamped, so with two cores the
+    // oldest slot is not always the earliest time.
+    uint32_t base = 0;
+    for (uint32_t n = 0; n < count; n++) {
+        uint32_t ts = events[(first + n) % TRACE_BUF_EVENTS].ts;
+        if (n == 0 || ts < base) base = ts;
+    }
+
+    Serial.printf("[TRACE] ---- begin, %lu events ----\n", (unsigned long)count);
+    Serial.println("{\"traceEvents\":[");
+    for (uint32_t n = 0; n < count; n++) {
+        const Event& e = events[(first + n) % TRACE_BUF_EVENTS];
+        int tid = 0;
+        while (tid < taskCount && tasks[tid] != e.task) tid++;
+        if (tid == taskCount && taskCount < 16) tasks[taskCount++] = e.task;
+        Serial.printf("{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lu,\"pid\":1,\"tid\":%d},\n",
+                      e.name, e.phase, (unsigned long)(e.ts - base), tid + 1);
+    }
+    for (int t = 0; t < taskCount; t++) {
+        Serial.printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                      "\"args\":{\"name\":\"%s\"}},\n",
+                      t + 1, pcTaskGetName(tasks[t]));
+    }
+    // Closing metadata entry, so every event above can end with a comma.
+    Serial.println("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                   "\"args\":{\"name\":\"" APP_NAME "\"}}]}");
+    Serial.println("[TRACE] ---- end ----");
+
+    restart(false);
+}
+
+}
+
+extern "C" void trace_begin(const char* name) {
+    Trace::record(name, 'B');
+}
+
+extern "C" void trace_end(const char* name) {
+    Trace::record(name, 'E');
+}
+
+#endif
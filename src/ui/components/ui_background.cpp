@@ -11,10 +11,12 @@ lv_obj_t *ui_background_create(lv_obj_t *parent, const ui_background_config_t *c
     lv_obj_t *img = lv_image_create(parent);
     lv_image_set_src(img, config->image_src);
     
-    // Auto-scale image to fit screen
+    // Assets from tools/img2c.py are already screen-sized and drawn 1:1.
+    // Anything else is scaled to cover, at the cost of LVGL's transform path
+    // on every redraw.
     int aw = config->image_src->header.w;
     int ah = config->image_src->header.h;
-    if (aw > 0 && ah > 0) {
+    if (aw > 0 && ah > 0 && (aw != SCREEN_WIDTH || ah != SCREEN_HEIGHT)) {
         uint32_t sw = ((uint32_t)SCREEN_WIDTH * 256u) / (uint32_t)aw;
         uint32_t sh = ((uint32_t)SCREEN_HEIGHT * 256u) / (uint32_t)ah;
         uint32_t s = sw > sh ? sw : sh;
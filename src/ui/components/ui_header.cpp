@@ -9,12 +9,8 @@ lv_obj_t *ui_header_create(lv_obj_t *parent, const ui_header_config_t *config)
     lv_obj_t *header = lv_obj_create(parent);
     lv_obj_set_size(header, 240, 38);
     lv_obj_align(header, LV_ALIGN_TOP_MID, 0, 0);
-    lv_obj_set_style_bg_color(header, lv_color_hex(0xe9d4a9), 0);
-    lv_obj_set_style_bg_opa(header, LV_OPA_COVER, 0);
-    lv_obj_set_style_border_width(header, 0, 0);
-    lv_obj_set_style_radius(header, 0, 0);
-    lv_obj_set_style_pad_left(header, 6, 0);
-    lv_obj_set_style_pad_right(header, 6, 0);
+    ensure_styles();
+    lv_obj_add_style(header, &style_header, 0);
     lv_obj_clear_flag(header, LV_OBJ_FLAG_SCROLLABLE);
 
     // Set flex layout based on whether we're centering and have a back button
@@ -40,7 +36,6 @@ lv_obj_t *ui_header_create(lv_obj_t *parent, const ui_header_config_t *config)
         }
         
         lv_obj_t *back_label = lv_label_create(btn_back);
-        lv_obj_set_style_text_font(back_label, font14(), 0);
         lv_label_set_text(back_label, config->back_button_text ? config->back_button_text : "<");
         lv_obj_center(back_label);
     }
@@ -48,9 +43,8 @@ lv_obj_t *ui_header_create(lv_obj_t *parent, const ui_header_config_t *config)
     // Title label
     if (config->title_text) {
         lv_obj_t *title_label = lv_label_create(header);
-        lv_obj_set_style_text_font(title_label, font16(), 0);
+        lv_obj_add_style(title_label, &style_header_title, 0);
         lv_label_set_text(title_label, config->title_text);
-        lv_obj_set_style_text_color(title_label, lv_color_black(), 0);
         
         // Enable marquee for long titles (only if not centered)
         if (config->enable_marquee && !config->center_title) {
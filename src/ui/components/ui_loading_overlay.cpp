@@ -6,30 +6,27 @@ lv_obj_t* ui_loading_overlay_create(lv_obj_t* parent, const ui_loading_overlay_c
 {
     lv_obj_t *overlay = lv_obj_create(parent);
     lv_obj_remove_style_all(overlay);
+    ensure_styles();
+    lv_obj_add_style(overlay, &style_overlay, 0);
     lv_obj_set_size(overlay, LV_PCT(100), LV_PCT(100));
-    lv_obj_set_style_bg_color(overlay, lv_color_black(), 0);
-    lv_obj_set_style_bg_opa(overlay, LV_OPA_50, 0);
     lv_obj_center(overlay);
     lv_obj_add_flag(overlay, LV_OBJ_FLAG_CLICKABLE);
 
     lv_obj_t *box = lv_obj_create(overlay);
     lv_obj_set_size(box, config->box_width, config->box_height);
     lv_obj_center(box);
+    lv_obj_add_style(box, &style_overlay_box, 0);
     lv_obj_set_style_bg_color(box, config->box_color, 0);
-    lv_obj_set_style_bg_opa(box, LV_OPA_COVER, 0);
-    lv_obj_set_style_radius(box, 12, 0);
-    lv_obj_set_style_pad_all(box, 8, 0);
     lv_obj_clear_flag(box, LV_OBJ_FLAG_SCROLLABLE);
 
     lv_obj_t *spinner = lv_spinner_create(box);
     lv_obj_set_size(spinner, 32, 32);
     lv_obj_align(spinner, LV_ALIGN_TOP_MID, 0, 4);
-    lv_obj_set_style_arc_color(spinner, lv_color_hex(0x666666), LV_PART_MAIN);
+    // Track color comes from the theme.
     lv_obj_set_style_arc_color(spinner, config->spinner_color, LV_PART_INDICATOR);
 
     lv_obj_t *lbl = lv_label_create(box);
     lv_label_set_text(lbl, config->message);
-    lv_obj_set_style_text_font(lbl, font14(), 0);
     lv_obj_set_style_text_color(lbl, config->text_color, 0);
     lv_obj_align(lbl, LV_ALIGN_BOTTOM_MID, 0, -4);
 
@@ -1,6 +1,18 @@
 #pragma once
 #include <lvgl.h>
 
+// KIDDO_SUBSET_FONTS: generated by tools/subset_fonts.py at build time.
+#ifdef KIDDO_SUBSET_FONTS
+extern const lv_font_t subset_12;
+extern const lv_font_t subset_14;
+extern const lv_font_t subset_16;
+extern const lv_font_t subset_20;
+
+#define KIDDO_FONT_12 subset_12
+#define KIDDO_FONT_14 subset_14
+#define KIDDO_FONT_16 subset_16
+#define KIDDO_FONT_20 subset_20
+#else
 extern const lv_font_t montserrat_12;
 extern const lv_font_t montserrat_14;
 extern const lv_font_t montserrat_16;
@@ -10,6 +22,7 @@ extern const lv_font_t montserrat_20;
 #define KIDDO_FONT_14 montserrat_14
 #define KIDDO_FONT_16 montserrat_16
 #define KIDDO_FONT_20 montserrat_20
+#endif
 
 
 inline const lv_font_t* font12(){
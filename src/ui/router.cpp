@@ -4,6 +4,32 @@
 
 namespace ui_router
 {
+    static lv_obj_t *g_home = nullptr;
+    static lv_obj_t *g_library = nullptr;
+    static lv_obj_t *g_page = nullptr;
+
+    static lv_obj_t *ensure_screen(lv_obj_t *&scr)
+    {
+        if (!scr)
+            scr = lv_obj_create(NULL);
+        return scr;
+    }
+
+    lv_obj_t *home_screen() { return ensure_screen(g_home); }
+    lv_obj_t *library_screen() { return ensure_screen(g_library); }
+    lv_obj_t *page_screen() { return ensure_screen(g_page); }
+
+    void load(lv_obj_t *scr)
+    {
+        lv_obj_t *old = lv_screen_active();
+        if (old == scr)
+            return;
+        lv_screen_load(scr);
+        // Story pages hold decoded images; don't keep them off screen.
+        if (old && old == g_page)
+            lv_obj_clean(g_page);
+    }
+
     void show_home()
     {
         ui_app_show_home();
@@ -11,5 +37,10 @@ namespace ui_router
     void show_library() { ui_library_screen_show(); }
     void show_story(const Story_t &st, const String &nodeKey) { ui_story_screen_show(st, nodeKey); }
     void show_splash(const char *msg) { ui_splash_screen_show(msg); }
-    void show_settings() { ui_settings_screen_show(); }
+    // Settings is an overlay on the home screen.
+    void show_settings()
+    {
+        ui_app_show_home();
+        ui_settings_screen_show();
+    }
 }
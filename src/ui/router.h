@@ -1,4 +1,5 @@
 #pragma once
+#include <lvgl.h>
 #include "models.h"
 #include "story_engine.h"
 namespace ui_router
@@ -8,4 +9,14 @@ namespace ui_router
     void show_story(const Story_t &st, const String &nodeKey);
     void show_splash(const char *msg = nullptr);
     void show_settings();
+
+    // Retained LVGL screens, created on first use and never deleted. Home and
+    // library keep their widgets between visits; the page screen holds the
+    // story reader and is emptied whenever another screen is loaded.
+    lv_obj_t *home_screen();
+    lv_obj_t *library_screen();
+    lv_obj_t *page_screen();
+
+    // lv_screen_load without animation; a no-op if scr is already active.
+    void load(lv_obj_t *scr);
 }
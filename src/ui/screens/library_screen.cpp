@@ -3,7 +3,7 @@
 #include <lvgl.h>
 #include <FS.h>
 #include <ArduinoJson.h>
-#include <set>
+#include <algorithm>
 #include "remote_catalog.h"
 #include "ui_screens.h"
 #include "styles.h"
@@ -12,10 +12,12 @@
 #include "config.h"
 #include "file_system.h"
 #include "async_manager.h"
+#include "image_display.h"
 #include "audio.h"
 #include "ui/components/ui_components.h"
 #include "ui/router.h"
 #include "story_utils.h"
+#include "library_model.h"
 int g_story_idx = -1;
 String g_node_key;
 ui_story_home_cb_t g_home_cb = nullptr;
@@ -40,10 +42,7 @@ static lv_obj_t* create_loading_overlay(lv_obj_t *parent, const char* message) {
     ui_loading_overlay_config_t config = ui_loading_overlay_config_default(message);
     return ui_loading_overlay_create(parent, &config);
 }
-static bool file_exists_strict(const String &path)
-{
-	return FileSystem::exists(path) && FileSystem::readFile(path).length() > 0;
-}
+static void update_rows_in_place();
 
 static void library_fetch_timer_cb(lv_timer_t *t)
 {
@@ -64,8 +63,11 @@ static void library_fetch_timer_cb(lv_timer_t *t)
 			g_fetch_overlay = nullptr;
 		}
 		
-		story::loadFromFS();
-		ui_library_screen_show();
+		update_rows_in_place();
+		if (!g_remote_fetch_failed)
+		{
+			library::refresh([](int) { update_rows_in_place(); });
+		}
 		
 		if (g_fetch_timer)
 		{
@@ -81,25 +83,23 @@ static void on_back_button_clicked(lv_event_t *e)
 	ui_router::show_home();
 }
 
-static void on_story_select(lv_event_t *e)
+static void open_local_story(int idx)
 {
-	intptr_t idx = (intptr_t)lv_event_get_user_data(e);
 	const auto &stories = story::all();
 	if (idx < 0 || (size_t)idx >= stories.size()) {
 		return;
 	}
-	g_story_idx = (int)idx;
+	g_story_idx = idx;
 	g_node_key = stories[g_story_idx].start;
 	ui_story_screen_show(stories[g_story_idx], g_node_key);
 }
-static void on_remote_entry(lv_event_t *e)
+static void download_remote_entry(int ridx)
 {
-	intptr_t ridx = (intptr_t)lv_event_get_user_data(e);
 	const auto &ents = remote_catalog::entries();
 	if (ridx < 0 || (size_t)ridx >= ents.size()) {
 		return;
 	}
-	g_pending_download_idx = (int)ridx;
+	g_pending_download_idx = ridx;
 	g_pending_download_file = ents[ridx].file;
 
 	if (!g_download_overlay)
@@ -115,9 +115,10 @@ static void on_remote_entry(lv_event_t *e)
 	else
 	{
 		String file = g_pending_download_file;
+		String lang = ents[ridx].lang;
 		g_pending_download_file.clear();
 		
-		AsyncManager::downloadStory(file, [](bool success, const String& storyId) {
+		AsyncManager::downloadStory(file, [file, lang](bool success, const String& storyId) {
 			if (g_download_overlay) {
 				lv_obj_del(g_download_overlay);
 				g_download_overlay = nullptr;
@@ -132,8 +133,9 @@ static void on_remote_entry(lv_event_t *e)
 				return;
 			}
 			
+			library::markInstalled(file, lang);
+			// deliver() has already reloaded the story list.
 			if (storyId.length()) {
-				story::loadFromFS();
 				const auto &stories = story::all();
 				for (const auto &st : stories) {
 					if (st.id == storyId) {
@@ -146,14 +148,208 @@ static void on_remote_entry(lv_event_t *e)
 		});
 	}
 }
+static void retry_catalog_fetch()
+{
+	g_remote_fetch_done = false;
+	g_remote_fetch_failed = false;
+	remote_catalog::invalidate();
+	if (g_fetch_timer)
+	{
+		lv_timer_del(g_fetch_timer);
+		g_fetch_timer = nullptr;
+	}
+	ui_library_screen_show();
+}
 
-extern void ui_app_before_screen_change();
-void ui_library_screen_show()
+// The list is virtualized: library::rows() describes every entry, while only
+// LIBRARY_POOL_ROWS buttons exist. Row r lives in slot r % LIBRARY_POOL_ROWS
+// at y = r * pitch, so scrolling by one row rebinds one button; a spacer at
+// the end gives the list its full scroll height.
+struct RowSlot
+{
+	lv_obj_t *btn;
+	lv_obj_t *lbl;
+	lv_obj_t *thumb;
+	int bound;
+};
+
+static const int32_t ROW_PITCH = LIBRARY_ROW_HEIGHT + LIBRARY_ROW_GAP;
+// Rows bound above the viewport; the rest of the pool covers it and below.
+static const int32_t ROW_MARGIN = 2;
+
+static RowSlot g_slots[LIBRARY_POOL_ROWS];
+static lv_obj_t *g_library_list = nullptr;
+static lv_obj_t *g_list_spacer = nullptr;
+static lv_obj_t *g_empty_state = nullptr;
+static lv_obj_t *g_empty_help = nullptr;
+static Language g_library_lang;
+
+static void on_row_clicked(lv_event_t *e)
+{
+	const RowSlot *slot = (const RowSlot *)lv_event_get_user_data(e);
+	const auto &rows = library::rows();
+	if (slot->bound < 0 || (size_t)slot->bound >= rows.size())
+	{
+		return;
+	}
+	const library::Row row = rows[slot->bound];
+	switch (row.kind)
+	{
+	case library::ROW_LOCAL:
+		open_local_story(row.index);
+		break;
+	case library::ROW_REMOTE:
+		download_remote_entry(row.index);
+		break;
+	case library::ROW_RETRY:
+		retry_catalog_fetch();
+		break;
+	}
+}
+
+static void bind_slot(RowSlot &slot, int r)
+{
+	slot.bound = r;
+	if (slot.thumb)
+	{
+		lv_obj_del(slot.thumb);
+		slot.thumb = nullptr;
+	}
+	if (r < 0)
+	{
+		lv_obj_add_flag(slot.btn, LV_OBJ_FLAG_HIDDEN);
+		return;
+	}
+	const library::Row &row = library::rows()[r];
+	lv_obj_clear_flag(slot.btn, LV_OBJ_FLAG_HIDDEN);
+	lv_obj_set_y(slot.btn, r * ROW_PITCH);
+
+	lv_palette_t color = LV_PALETTE_ORANGE;
+	const lv_font_t *font = font14();
+	if (row.kind == library::ROW_LOCAL)
+	{
+		const Story_t &st = story::all()[row.index];
+		lv_label_set_text(slot.lbl, st.title.length() ? st.title.c_str() : st.id.c_str());
+		font = font16();
+		slot.thumb = ImageDisplay::createThumbnail(slot.btn, FileSystem::getThumbnailPath(st.id));
+	}
+	else if (row.kind == library::ROW_REMOTE)
+	{
+		const auto &ent = remote_catalog::entries()[row.index];
+		lv_label_set_text(slot.lbl, ent.name.length() ? ent.name.c_str() : ent.file.c_str());
+		color = LV_PALETTE_BLUE;
+	}
+	else
+	{
+		lv_label_set_text(slot.lbl, S()->retry_online_fetch);
+		color = LV_PALETTE_RED;
+	}
+	lv_obj_set_style_bg_color(slot.btn, lv_palette_main(color), 0);
+	lv_obj_set_style_text_font(slot.lbl, font, 0);
+	if (slot.thumb)
+	{
+		// Cover flush with the left edge, title beside it.
+		lv_obj_align(slot.thumb, LV_ALIGN_LEFT_MID, 0, 0);
+		lv_obj_set_style_pad_left(slot.lbl, THUMB_WIDTH + 8, 0);
+		lv_obj_set_style_text_align(slot.lbl, LV_TEXT_ALIGN_LEFT, 0);
+	}
+	else
+	{
+		lv_obj_set_style_pad_left(slot.lbl, 10, 0);
+		lv_obj_set_style_text_align(slot.lbl, LV_TEXT_ALIGN_CENTER, 0);
+	}
+}
+
+// Bind the pool to the rows around the current scroll offset; slots that
+// already show the right row are left alone.
+static void bind_visible_rows()
+{
+	int32_t first = lv_obj_get_scroll_y(g_library_list) / ROW_PITCH - ROW_MARGIN;
+	if (first < 0)
+	{
+		first = 0;
+	}
+	for (int32_t r = first; r < first + LIBRARY_POOL_ROWS; ++r)
+	{
+		RowSlot &slot = g_slots[r % LIBRARY_POOL_ROWS];
+		int want = r < (int32_t)library::rows().size() ? (int)r : -1;
+		if (slot.bound != want)
+		{
+			bind_slot(slot, want);
+		}
+	}
+}
+
+static void on_list_scroll(lv_event_t *e)
+{
+	bind_visible_rows();
+}
+
+static void create_row_pool(lv_obj_t *list)
+{
+	for (int i = 0; i < LIBRARY_POOL_ROWS; ++i)
+	{
+		RowSlot &slot = g_slots[i];
+		slot.btn = lv_btn_create(list);
+		ui_add_click_sound(slot.btn);
+		lv_obj_set_size(slot.btn, LV_PCT(100), LIBRARY_ROW_HEIGHT);
+		apply_primary_button_style(slot.btn);
+		lv_obj_set_style_pad_all(slot.btn, 0, 0);
+		lv_obj_add_event_cb(slot.btn, on_row_clicked, LV_EVENT_CLICKED, &slot);
+		slot.lbl = lv_label_create(slot.btn);
+		lv_label_set_long_mode(slot.lbl, LV_LABEL_LONG_DOT);
+		lv_obj_set_width(slot.lbl, LV_PCT(100));
+		lv_obj_set_style_pad_right(slot.lbl, 10, 0);
+		lv_obj_align(slot.lbl, LV_ALIGN_LEFT_MID, 0, 0);
+		slot.thumb = nullptr;
+		slot.bound = -1;
+		lv_obj_add_flag(slot.btn, LV_OBJ_FLAG_HIDDEN);
+	}
+
+	// Invisible but not hidden: hidden children don't count toward the
+	// scrollable height.
+	g_list_spacer = lv_obj_create(list);
+	lv_obj_remove_style_all(g_list_spacer);
+	lv_obj_clear_flag(g_list_spacer, LV_OBJ_FLAG_CLICKABLE);
+	lv_obj_set_size(g_list_spacer, 1, 1);
+
+	// Create a container for the empty state below any rows (the retry button)
+	g_empty_state = lv_obj_create(list);
+	lv_obj_set_width(g_empty_state, LV_PCT(100));
+	lv_obj_add_style(g_empty_state, &style_plain, 0);
+	lv_obj_set_flex_flow(g_empty_state, LV_FLEX_FLOW_COLUMN);
+	lv_obj_set_flex_align(g_empty_state, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+	
+	// Main message
+	lv_obj_t *msg_lbl = lv_label_create(g_empty_state);
+	lv_label_set_text(msg_lbl, S()->no_stories);
+	lv_obj_set_style_text_font(msg_lbl, font14(), 0);
+	lv_obj_set_style_text_color(msg_lbl, lv_palette_main(LV_PALETTE_GREY), 0);
+	lv_obj_set_style_text_align(msg_lbl, LV_TEXT_ALIGN_CENTER, 0);
+	
+	// Additional helpful text
+	g_empty_help = lv_label_create(g_empty_state);
+	lv_obj_set_style_text_font(g_empty_help, font12(), 0);
+	lv_obj_set_style_text_color(g_empty_help, lv_palette_main(LV_PALETTE_GREY), 0);
+	lv_obj_set_style_text_align(g_empty_help, LV_TEXT_ALIGN_CENTER, 0);
+	lv_obj_set_style_margin_top(g_empty_help, 8, 0);
+	lv_label_set_long_mode(g_empty_help, LV_LABEL_LONG_WRAP);
+	lv_obj_set_width(g_empty_help, LV_PCT(80));
+	lv_obj_add_flag(g_empty_state, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Panel, header, list and its row pool are kept on the router's library
+// screen and rebuilt only after a language change.
+static lv_obj_t *ensure_library_skeleton(lv_obj_t *scr)
 {
-	ui_app_before_screen_change();
-	lv_obj_t *scr = lv_scr_act();
+	if (g_library_list && g_library_lang == current_language)
+	{
+		return g_library_list;
+	}
 	lv_obj_clean(scr);
 	g_fetch_overlay = nullptr;
+	g_download_overlay = nullptr;
+	g_library_lang = current_language;
 	const auto *s = S();
 	apply_screen_bg(scr);
 	lv_obj_t *panel = lv_obj_create(scr);
@@ -176,81 +372,91 @@ void ui_library_screen_show()
 	lv_obj_set_style_pad_right(list, 2, 0);
 	lv_obj_set_style_pad_top(list, 2, 0);
 	lv_obj_set_style_pad_bottom(list, 2, 0);
-	lv_obj_set_style_pad_row(list, 2, 0);
-	lv_obj_set_flex_flow(list, LV_FLEX_FLOW_COLUMN);
 	lv_obj_set_scroll_dir(list, LV_DIR_VER);
 	lv_obj_set_scrollbar_mode(list, LV_SCROLLBAR_MODE_AUTO);
-	lv_obj_set_style_max_height(list, 262, 0);
-	
-	const auto &storiesNow = story::all();
-	const auto &ents = remote_catalog::entries();
-	
-	bool any_local = !storiesNow.empty();
-	bool any_remote = false;
-	
-	for (size_t i = 0; i < storiesNow.size(); ++i)
+	lv_obj_add_event_cb(list, on_list_scroll, LV_EVENT_SCROLL, nullptr);
+	create_row_pool(list);
+	g_library_list = list;
+	return list;
+}
+
+// Rebind only the slots whose row changed, then fit the scroll height and
+// the empty state to the new row count.
+static void apply_row_diff(const library::Diff &diff)
+{
+	for (RowSlot &slot : g_slots)
 	{
-		const Story_t &st = storiesNow[i];
-		lv_obj_t *btn = lv_btn_create(list);
-		ui_add_click_sound(btn);
-		lv_obj_set_width(btn, LV_PCT(100));
-		lv_obj_set_height(btn, 36);
-		apply_primary_button_style(btn);
-		lv_obj_add_event_cb(btn, on_story_select, LV_EVENT_CLICKED, (void *)i);
-		lv_obj_t *lbl = lv_label_create(btn);
-		lv_label_set_text(lbl, st.title.length() ? st.title.c_str() : st.id.c_str());
-		lv_obj_set_style_text_font(lbl, font16(), 0);
-		lv_obj_center(lbl);
-	}
-	
-	if (online_mode) {
-		std::set<String> shown_file_lang;
-		
-		for (size_t i = 0; i < ents.size(); ++i)
+		if (slot.bound < 0)
 		{
-			const auto &ent = ents[i];
-			if (!story_utils::matchesLanguage(current_language, ent.lang)) continue;
-			
-			String unique_key = ent.file + "|" + ent.lang;
-			if (shown_file_lang.count(unique_key)) continue;
-			
-			shown_file_lang.insert(unique_key);
-			String label = ent.name.length() ? ent.name : ent.file;
-			
-			bool found_local = false;
-			String localPath = "/" + ent.file;
-			
-			// Check if file exists and is in the index with matching language
-			if (FileSystem::exists(localPath)) {
-				String payload = FileSystem::readFile(localPath);
-				if (payload.length() > 0) {
-					JsonDocument doc;
-					if (deserializeJson(doc, payload) == DeserializationError::Ok) {
-						String lang = doc["lang"].as<String>();
-						if (lang == ent.lang && FileSystem::indexContains(localPath)) {
-							found_local = true;
-						}
-					}
-				}
-			}
-			
-			if (!found_local)
-			{
-				any_remote = true;
-				lv_obj_t *btn = lv_btn_create(list);
-				ui_add_click_sound(btn);
-				lv_obj_set_width(btn, LV_PCT(100));
-				lv_obj_set_height(btn, 34);
-				apply_primary_button_style(btn);
-				lv_obj_set_style_bg_color(btn, lv_palette_main(LV_PALETTE_BLUE), 0);
-				lv_obj_add_event_cb(btn, on_remote_entry, LV_EVENT_CLICKED, (void *)i);
-				lv_obj_t *lbl = lv_label_create(btn);
-				lv_label_set_text(lbl, label.c_str());
-				lv_obj_set_style_text_font(lbl, font14(), 0);
-				lv_obj_center(lbl);
-			}
+			continue;
+		}
+		if (slot.bound >= diff.newCount ||
+			std::binary_search(diff.changed.begin(), diff.changed.end(), slot.bound))
+		{
+			bind_slot(slot, -1);
 		}
-	} else {
+	}
+
+	const auto &rows = library::rows();
+	int32_t rows_height = (int32_t)rows.size() * ROW_PITCH;
+	if (rows.empty())
+	{
+		lv_obj_add_flag(g_list_spacer, LV_OBJ_FLAG_HIDDEN);
+	}
+	else
+	{
+		lv_obj_clear_flag(g_list_spacer, LV_OBJ_FLAG_HIDDEN);
+		lv_obj_set_y(g_list_spacer, rows_height - LIBRARY_ROW_GAP - 1);
+	}
+	// If nothing to show, display 'no stories' message (below the retry row)
+	bool empty = rows.empty() || (rows.size() == 1 && rows[0].kind == library::ROW_RETRY);
+	if (empty)
+	{
+		const auto *s = S();
+		lv_label_set_text(g_empty_help, online_mode ? s->stories_will_appear : s->enable_online_mode);
+		lv_obj_set_y(g_empty_state, rows_height);
+		lv_obj_set_height(g_empty_state, lv_obj_get_content_height(g_library_list) - rows_height);
+		lv_obj_clear_flag(g_empty_state, LV_OBJ_FLAG_HIDDEN);
+	}
+	else
+	{
+		lv_obj_add_flag(g_empty_state, LV_OBJ_FLAG_HIDDEN);
+	}
+	lv_obj_update_layout(g_library_list);
+}
+
+static library::Diff update_rows()
+{
+	// Refreshes also land while a story is open, and it points into
+	// story::all(); pick up newly indexed stories once the list is showing.
+	if (lv_screen_active() == ui_router::library_screen())
+	{
+		library::reloadStories();
+	}
+	bool retry = online_mode && g_remote_fetch_done && g_remote_fetch_failed;
+	return library::update(online_mode, retry);
+}
+
+// Catalog fetches and installed-set refreshes land here while the list may
+// be on screen: keep the scroll position (clamped) and touch changed rows only.
+static void update_rows_in_place()
+{
+	if (!g_library_list)
+	{
+		return;
+	}
+	apply_row_diff(update_rows());
+	lv_obj_scroll_to_y(g_library_list, lv_obj_get_scroll_y(g_library_list), LV_ANIM_OFF);
+	bind_visible_rows();
+}
+
+void ui_library_screen_show()
+{
+	lv_obj_t *scr = ui_router::library_screen();
+	lv_obj_t *list = ensure_library_skeleton(scr);
+	ui_router::load(scr);
+	
+	if (!online_mode) {
 		g_remote_fetch_done = false;
 		g_remote_fetch_failed = false;
 		if (g_fetch_timer) {
@@ -263,35 +469,11 @@ void ui_library_screen_show()
 		}
 	}
 	
-	// If nothing to show, display 'no stories' message
-	if (!any_local && !any_remote)
-	{
-		// Create a container for the empty state that takes up the full list area
-		lv_obj_t *empty_container = lv_obj_create(list);
-		lv_obj_set_size(empty_container, LV_PCT(100), LV_PCT(100));
-		lv_obj_set_style_bg_opa(empty_container, LV_OPA_TRANSP, 0);
-		lv_obj_set_style_border_width(empty_container, 0, 0);
-		lv_obj_set_style_pad_all(empty_container, 0, 0);
-		lv_obj_set_flex_flow(empty_container, LV_FLEX_FLOW_COLUMN);
-		lv_obj_set_flex_align(empty_container, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-		
-		// Main message
-		lv_obj_t *msg_lbl = lv_label_create(empty_container);
-		lv_label_set_text(msg_lbl, s->no_stories);
-		lv_obj_set_style_text_font(msg_lbl, font14(), 0);
-		lv_obj_set_style_text_color(msg_lbl, lv_palette_main(LV_PALETTE_GREY), 0);
-		lv_obj_set_style_text_align(msg_lbl, LV_TEXT_ALIGN_CENTER, 0);
-		
-		// Additional helpful text
-		lv_obj_t *help_lbl = lv_label_create(empty_container);
-		lv_label_set_text(help_lbl, online_mode ? s->stories_will_appear : s->enable_online_mode);
-		lv_obj_set_style_text_font(help_lbl, font12(), 0);
-		lv_obj_set_style_text_color(help_lbl, lv_palette_main(LV_PALETTE_GREY), 0);
-		lv_obj_set_style_text_align(help_lbl, LV_TEXT_ALIGN_CENTER, 0);
-		lv_obj_set_style_margin_top(help_lbl, 8, 0);
-		lv_label_set_long_mode(help_lbl, LV_LABEL_LONG_WRAP);
-		lv_obj_set_width(help_lbl, LV_PCT(80));
-	}	// Online mode phased loading with states
+	apply_row_diff(update_rows());
+	lv_obj_scroll_to_y(list, 0, LV_ANIM_OFF);
+	bind_visible_rows();
+	
+	// Online mode phased loading with states
 	if (online_mode)
 	{
 		if (!g_remote_fetch_done)
@@ -306,39 +488,10 @@ void ui_library_screen_show()
 				g_fetch_timer = lv_timer_create(library_fetch_timer_cb, 50, nullptr);
 			}
 		}
-		else if (g_remote_fetch_failed)
+		else if (!g_remote_fetch_failed)
 		{
-			lv_obj_t *btn_retry = lv_btn_create(list);
-			ui_add_click_sound(btn_retry);
-			lv_obj_set_width(btn_retry, LV_PCT(100));
-			lv_obj_set_height(btn_retry, 36);
-			apply_primary_button_style(btn_retry);
-			lv_obj_set_style_bg_color(btn_retry, lv_palette_main(LV_PALETTE_RED), 0);
-			lv_obj_add_event_cb(btn_retry, [](lv_event_t *e)
-			{
-				g_remote_fetch_done = false;
-				g_remote_fetch_failed = false;
-				remote_catalog::invalidate();
-				if (g_fetch_timer)
-				{
-					lv_timer_del(g_fetch_timer);
-					g_fetch_timer = nullptr;
-				}
-				ui_library_screen_show();
-			}, LV_EVENT_CLICKED, nullptr);
-			lv_obj_t *lblr = lv_label_create(btn_retry);
-			lv_label_set_text(lblr, S()->retry_online_fetch);
-			lv_obj_center(lblr);
-		}
-		else
-		{
-			int newly = remote_catalog::reconcileExisting();
-			if (newly > 0)
-			{
-				story::loadFromFS();
-				ui_library_screen_show();
-				return;
-			}
+			// Stories may have been installed or removed since the last visit.
+			library::refresh([](int) { update_rows_in_place(); });
 		}
 	}
 }
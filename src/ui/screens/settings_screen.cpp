@@ -60,17 +60,11 @@ static void wifi_reset_cb(lv_event_t *) {
         lv_obj_t *toast = lv_obj_create(lv_scr_act());
         lv_obj_set_size(toast, LV_PCT(100), LV_SIZE_CONTENT);
         lv_obj_align(toast, LV_ALIGN_BOTTOM_MID, 0, 0);
-        lv_obj_set_style_bg_color(toast, lv_palette_main(LV_PALETTE_GREEN), 0);
-        lv_obj_set_style_bg_opa(toast, LV_OPA_COVER, 0);
-        lv_obj_set_style_border_width(toast, 0, 0);
-        lv_obj_set_style_pad_all(toast, 16, 0);
-        lv_obj_set_style_radius(toast, 0, 0);
+        lv_obj_add_style(toast, &style_toast, 0);
         
         lv_obj_t *toast_msg = lv_label_create(toast);
         lv_label_set_text(toast_msg, s->wifi_reset_toast);
-        lv_obj_set_style_text_font(toast_msg, font14(), 0);
-        lv_obj_set_style_text_color(toast_msg, lv_color_white(), 0);
-        lv_obj_set_style_text_align(toast_msg, LV_TEXT_ALIGN_CENTER, 0);
+        lv_obj_add_style(toast_msg, &style_toast_text, 0);
         lv_obj_center(toast_msg);
         
         lv_timer_create([](lv_timer_t *t) {
@@ -112,7 +106,7 @@ void ui_settings_screen_show()
         lv_obj_move_foreground(settings_root);
         return;
     }
-    ensure_compact_style();
+    ensure_styles();
     auto *s = S();
     settings_root = lv_obj_create(lv_scr_act());
     lv_obj_remove_style_all(settings_root);
@@ -277,17 +271,11 @@ void ui_settings_screen_show()
             lv_obj_t *toast = lv_obj_create(lv_scr_act());
             lv_obj_set_size(toast, LV_PCT(100), LV_SIZE_CONTENT);
             lv_obj_align(toast, LV_ALIGN_BOTTOM_MID, 0, 0);
-            lv_obj_set_style_bg_color(toast, lv_palette_main(LV_PALETTE_GREEN), 0);
-            lv_obj_set_style_bg_opa(toast, LV_OPA_COVER, 0);
-            lv_obj_set_style_border_width(toast, 0, 0);
-            lv_obj_set_style_pad_all(toast, 16, 0);
-            lv_obj_set_style_radius(toast, 0, 0);
+            lv_obj_add_style(toast, &style_toast, 0);
             
             lv_obj_t *toast_msg = lv_label_create(toast);
             lv_label_set_text(toast_msg, "Catalog URL updated");
-            lv_obj_set_style_text_font(toast_msg, font14(), 0);
-            lv_obj_set_style_text_color(toast_msg, lv_color_white(), 0);
-            lv_obj_set_style_text_align(toast_msg, LV_TEXT_ALIGN_CENTER, 0);
+            lv_obj_add_style(toast_msg, &style_toast_text, 0);
             lv_obj_center(toast_msg);
             
             lv_timer_create([](lv_timer_t *t) {
@@ -5,11 +5,17 @@
 #include "ui/images/image_splash.h"
 #include "config.h"
 #include "ui/components/ui_components.h"
+#include "ui/router.h"
 
 void ui_splash_screen_show(const char *msg)
 {
-    lv_obj_t *scr = lv_obj_create(NULL);
-    lv_scr_load(scr);
+    // One screen reused for every splash, so repeated messages don't leak.
+    static lv_obj_t *scr = nullptr;
+    if (!scr)
+        scr = lv_obj_create(NULL);
+    else
+        lv_obj_clean(scr);
+    ui_router::load(scr);
 
     ui_background_config_t bg_config = ui_background_config_default(&image_splash);
     ui_background_create(scr, &bg_config);
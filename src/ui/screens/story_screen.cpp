@@ -12,6 +12,8 @@
 #include "ui/fonts.h"
 #include "ui_screens.h"
 #include "kiddo_parser.h"
+#include "ui/router.h"
+#include "trace.h"
 
 extern void ui_library_screen_show();
 extern void ui_story_set_home_cb(void (*cb)());
@@ -20,6 +22,14 @@ namespace
 {
 	String g_current_node;
 	const Story_t *g_story = nullptr;
+	// Retained widgets of the story being shown; reset when they are deleted.
+	const Story_t *g_skeleton_story = nullptr;
+	lv_obj_t *g_text_wrap = nullptr;
+	lv_obj_t *g_choices = nullptr;
+#if DISPLAY_BENCHMARK
+	uint32_t g_tap_us = 0;
+	bool g_frame_rendered = false;
+#endif
 }
 
 extern uint8_t story_font_scale;
@@ -54,9 +64,14 @@ static bool should_wrap_choice(const String &text)
 	return w > (max_line_width + 40);
 }
 
+static void end_screen_clicked(lv_event_t *e)
+{
+	ui_library_screen_show();
+}
+
 static void show_end_fullscreen()
 {
-	lv_obj_t *scr = lv_scr_act();
+	lv_obj_t *scr = ui_router::page_screen();
 	lv_obj_clean(scr);
 	const auto *s = S();
 	lv_obj_set_style_bg_color(scr, lv_color_white(), 0);
@@ -66,37 +81,73 @@ static void show_end_fullscreen()
 	lv_obj_set_style_text_font(lbl, font20(), 0);
 	lv_obj_set_style_text_color(lbl, lv_color_hex(0x000000), 0);
 	lv_obj_center(lbl);
-	lv_obj_add_event_cb(
-		scr,
-		[](lv_event_t *e)
-		{
-			if (lv_event_get_code(e) == LV_EVENT_CLICKED)
-				ui_library_screen_show();
-		},
-		LV_EVENT_CLICKED, nullptr);
+	lv_obj_add_event_cb(scr, end_screen_clicked, LV_EVENT_CLICKED, nullptr);
 }
 
-static void show_node(const String &key)
+static void show_node_at(int index);
+
+static void on_choice_clicked(lv_event_t *e)
 {
-	if (!g_story)
-		return;
-	const Node_t *n = g_story->get(key);
-	if (!n)
+	TRACE_SCOPE("choice_clicked");
+#if DISPLAY_BENCHMARK
+	g_tap_us = micros();
+	g_frame_rendered = false;
+#endif
+	show_node_at((int)(intptr_t)lv_event_get_user_data(e));
+}
+
+#if DISPLAY_BENCHMARK
+// Tap-to-frame latency: the first display refresh that actually rendered
+// something after a choice tap.
+static void frame_event_cb(lv_event_t *e)
+{
+	if (lv_event_get_code(e) == LV_EVENT_RENDER_START)
 	{
-		ui_library_screen_show();
+		g_frame_rendered = true;
 		return;
 	}
-	g_current_node = key;
-	lv_obj_t *scr = lv_scr_act();
+	if (g_tap_us && g_frame_rendered)
+	{
+		Serial.printf("[STORY] Tap to frame: %lu us\n", (unsigned long)(micros() - g_tap_us));
+		g_tap_us = 0;
+	}
+}
+#endif
+
+static void skeleton_delete_cb(lv_event_t *e)
+{
+	g_skeleton_story = nullptr;
+	g_text_wrap = nullptr;
+	g_choices = nullptr;
+}
+
+// Header, content column, scrolling text area and choice panel. Built once
+// per story; later nodes only replace the children of g_text_wrap and
+// g_choices.
+static void build_skeleton()
+{
+	lv_obj_t *scr = ui_router::page_screen();
 	lv_obj_clean(scr);
-	const auto *s = S();
+	// The page screen outlives its content; drop a handler left by the end page.
+	lv_obj_remove_event_cb(scr, end_screen_clicked);
 	lv_obj_set_style_bg_color(scr, lv_color_white(), 0);
 	lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+
+#if DISPLAY_BENCHMARK
+	static bool frame_timing_hooked = false;
+	if (!frame_timing_hooked)
+	{
+		lv_display_t *disp = lv_display_get_default();
+		lv_display_add_event_cb(disp, frame_event_cb, LV_EVENT_RENDER_START, nullptr);
+		lv_display_add_event_cb(disp, frame_event_cb, LV_EVENT_REFR_READY, nullptr);
+		frame_timing_hooked = true;
+	}
+#endif
 	
 	auto on_back_clicked = [](lv_event_t *e) { ui_library_screen_show(); };
 	ui_header_config_t config = ui_header_config_default(g_story->title.c_str(), on_back_clicked);
 	config.enable_marquee = true;
-	lv_obj_t *header = ui_header_create(scr, &config);
+	ui_header_create(scr, &config);
 	int header_h = 44;
 	
 	lv_coord_t content_h = SCREEN_HEIGHT - header_h;
@@ -106,12 +157,14 @@ static void show_node(const String &key)
 	lv_obj_align(content, LV_ALIGN_TOP_MID, 0, header_h);
 	lv_obj_set_style_bg_color(content, lv_color_white(), 0);
 	lv_obj_set_style_bg_opa(content, LV_OPA_COVER, 0);
+	// Body font and color for the text and choice labels below.
+	lv_obj_add_style(content, &style_story_text, 0);
 	lv_obj_set_flex_flow(content, LV_FLEX_FLOW_COLUMN);
 	lv_obj_set_flex_align(content, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START,
 						  LV_FLEX_ALIGN_START);
+	lv_obj_add_event_cb(content, skeleton_delete_cb, LV_EVENT_DELETE, nullptr);
 	lv_obj_t *text_wrap = lv_obj_create(content);
 	lv_obj_remove_style_all(text_wrap);
-	lv_obj_set_style_bg_opa(text_wrap, LV_OPA_TRANSP, 0);
 	lv_obj_set_width(text_wrap, 240);
 	lv_obj_set_style_pad_left(text_wrap, 6, 0);
 	lv_obj_set_style_pad_right(text_wrap, 6, 0);
@@ -123,7 +176,22 @@ static void show_node(const String &key)
 	lv_obj_set_flex_align(text_wrap, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START,
 						  LV_FLEX_ALIGN_START);
 	lv_obj_set_flex_grow(text_wrap, 1);
-	
+
+	lv_obj_t *choices = lv_obj_create(content);
+	lv_obj_remove_style_all(choices);
+	lv_obj_set_width(choices, 240);
+	lv_obj_add_style(choices, &style_choice_panel, 0);
+	lv_obj_set_flex_flow(choices, LV_FLEX_FLOW_COLUMN);
+	lv_obj_set_flex_align(choices, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START,
+						  LV_FLEX_ALIGN_START);
+
+	g_skeleton_story = g_story;
+	g_text_wrap = text_wrap;
+	g_choices = choices;
+}
+
+static void add_segments(lv_obj_t *text_wrap, const Node_t *n)
+{
 	KiddoParser::ParsedContent parsed = KiddoParser::parseText(n->text);
 	
 	for (const auto& segment : parsed.segments) {
@@ -133,19 +201,13 @@ static void show_node(const String &key)
 				lv_label_set_long_mode(text_label, LV_LABEL_LONG_WRAP);
 				lv_obj_set_width(text_label, 228);
 				lv_label_set_text(text_label, segment.content.c_str());
-				lv_obj_set_style_text_font(text_label, story_body_font(), 0);
-				lv_obj_set_style_text_color(text_label, lv_color_hex(0x000000), 0);
 			}
 		} else if (segment.type == KiddoParser::ContentSegment::IMAGE) {
 			lv_obj_t *img_wrapper = lv_obj_create(text_wrap);
 			lv_obj_remove_style_all(img_wrapper);
-			lv_obj_set_style_bg_opa(img_wrapper, LV_OPA_TRANSP, 0);
+			lv_obj_add_style(img_wrapper, &style_story_image, 0);
 			lv_obj_set_width(img_wrapper, 228);
 			lv_obj_set_height(img_wrapper, 140);
-			lv_obj_set_style_pad_bottom(img_wrapper, 6, 0);
-			lv_obj_set_style_pad_top(img_wrapper, 3, 0);
-			lv_obj_set_style_pad_left(img_wrapper, 0, 0);
-			lv_obj_set_style_pad_right(img_wrapper, 0, 0);
 			lv_obj_set_scroll_dir(img_wrapper, LV_DIR_NONE);
 			lv_obj_set_flex_flow(img_wrapper, LV_FLEX_FLOW_COLUMN);
 			lv_obj_set_flex_align(img_wrapper, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
@@ -164,90 +226,59 @@ static void show_node(const String &key)
 			});
 		}
 	}
-	lv_obj_t *choices = lv_obj_create(content);
-	lv_obj_remove_style_all(choices);
-	lv_obj_set_width(choices, 240);
-	lv_obj_set_style_bg_color(choices, lv_color_hex(0xe9d4a9), 0);
-	lv_obj_set_style_bg_opa(choices, LV_OPA_COVER, 0);
-	lv_obj_set_style_pad_all(choices, 6, 0);
-	lv_obj_set_style_pad_row(choices, 6, 0);
-	lv_obj_set_style_border_width(choices, 0, 0);
-	lv_obj_set_flex_flow(choices, LV_FLEX_FLOW_COLUMN);
-	lv_obj_set_flex_align(choices, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START,
-						  LV_FLEX_ALIGN_START);
+}
+
+static lv_obj_t *add_choice_button(lv_obj_t *choices, const String &text)
+{
+	lv_obj_t *b = lv_btn_create(choices);
+	ui_add_click_sound(b);
+	apply_primary_button_style(b);
+	// Full width, at least 34 px; wrapped choices grow with their text.
+	lv_obj_add_style(b, &style_choice_btn, 0);
+	bool wrap = should_wrap_choice(text);
+	if (!wrap)
+	{
+		lv_obj_set_height(b, 34);
+	}
+	lv_obj_t *l = lv_label_create(b);
+	lv_label_set_text(l, text.c_str());
+	if (wrap)
+	{
+		lv_label_set_long_mode(l, LV_LABEL_LONG_WRAP);
+		lv_obj_set_width(l, 200);
+	}
+	lv_obj_center(l);
+	return b;
+}
+
+static void add_choices(lv_obj_t *choices, const Node_t *n)
+{
 	if (n->is_end || n->choices.empty())
 	{
-		lv_obj_t *b = lv_btn_create(choices);
-		ui_add_click_sound(b);
-		ui_add_click_sound(b);
-		lv_obj_set_width(b, LV_PCT(100));
-		bool wrap = should_wrap_choice(String(S()->end_next));
-		if (wrap)
-		{
-			lv_obj_set_height(b, LV_SIZE_CONTENT);
-			lv_obj_set_style_min_height(b, 34, 0);
-		}
-		else
-		{
-			lv_obj_set_height(b, 34);
-		}
-		apply_primary_button_style(b);
+		lv_obj_t *b = add_choice_button(choices, String(S()->end_next));
 		lv_obj_add_event_cb(
 			b, [](lv_event_t *e)
 			{ show_end_fullscreen(); }, LV_EVENT_CLICKED,
 			nullptr);
-		lv_obj_t *l = lv_label_create(b);
-		lv_label_set_text(l, S()->end_next);
-		lv_obj_set_style_text_font(l, story_body_font(), 0);
-		if (wrap)
-		{
-			lv_label_set_long_mode(l, LV_LABEL_LONG_WRAP);
-			lv_obj_set_width(l, 200);
-		}
-		lv_obj_center(l);
 	}
 	else
 	{
 		for (const auto &ch : n->choices)
 		{
-			lv_obj_t *b = lv_btn_create(choices);
-			ui_add_click_sound(b);
-			ui_add_click_sound(b);
-			lv_obj_set_width(b, LV_PCT(100));
-			bool wrap = should_wrap_choice(ch.text);
-			if (wrap)
-			{
-				lv_obj_set_height(b, LV_SIZE_CONTENT);
-				lv_obj_set_style_min_height(b, 34, 0);
-			}
-			else
-			{
-				lv_obj_set_height(b, 34);
-			}
-			apply_primary_button_style(b);
-			char *nextKey = (char *)malloc(ch.next.length() + 1);
-			strcpy(nextKey, ch.next.c_str());
-			lv_obj_add_event_cb(
-				b,
-				[](lv_event_t *e)
-				{
-					char *nk = (char *)lv_event_get_user_data(e);
-					if (!nk)
-						return;
-					String key = nk;
-					free(nk);
-					show_node(key);
-				},
-				LV_EVENT_CLICKED, nextKey);
-			lv_obj_t *l = lv_label_create(b);
-			lv_label_set_text(l, ch.text.c_str());
-			lv_obj_set_style_text_font(l, story_body_font(), 0);
-			if (wrap)
-			{
-				lv_label_set_long_mode(l, LV_LABEL_LONG_WRAP);
-				lv_obj_set_width(l, 200);
-			}
-			lv_obj_center(l);
+			lv_obj_t *b = add_choice_button(choices, ch.text);
+			lv_obj_add_event_cb(b, on_choice_clicked, LV_EVENT_CLICKED,
+								(void *)(intptr_t)ch.next_index);
+		}
+	}
+	for (const auto &ch : n->choices)
+	{
+		if (ch.next_index < 0)
+			continue;
+		const Node_t &next = g_story->nodes[ch.next_index].second;
+		for (const String &url : KiddoParser::getImageUrls(next.text))
+		{
+			if (!AsyncManager::prefetchImage(url))
+				break;
 		}
 	}
 	uint32_t choice_cnt = lv_obj_get_child_cnt(choices);
@@ -258,9 +289,6 @@ static void show_node(const String &key)
 		base_pad * 2 + (choice_cnt > 0 ? (btn_h * (int)choice_cnt +
 										  row_space * ((int)choice_cnt - 1))
 									   : 0);
-	int max_compact_two =
-		base_pad * 2 +
-		(btn_h * 2 + row_space);
 	int max_cap = 110;
 	if (choice_cnt <= 2)
 	{
@@ -276,16 +304,61 @@ static void show_node(const String &key)
 		lv_obj_set_scroll_dir(choices, LV_DIR_VER);
 		lv_obj_add_flag(choices, LV_OBJ_FLAG_SCROLLABLE);
 	}
-	lv_obj_move_foreground(choices);
+}
+
+static void show_node_at(int index)
+{
+	TRACE_SCOPE("show_node");
+	if (!g_story)
+		return;
+	if (index < 0 || (size_t)index >= g_story->nodes.size())
+	{
+		ui_library_screen_show();
+		return;
+	}
+#if DISPLAY_BENCHMARK
+	uint32_t t0 = micros();
+#endif
+	const Node_t *n = &g_story->nodes[index].second;
+	g_current_node = g_story->nodes[index].first;
+	set_story_text_font(story_body_font());
+
+	if (g_skeleton_story != g_story || !g_text_wrap)
+	{
+		build_skeleton();
+	}
+	else
+	{
+		lv_obj_clean(g_text_wrap);
+		lv_obj_clean(g_choices);
+		lv_obj_scroll_to_y(g_text_wrap, 0, LV_ANIM_OFF);
+		lv_obj_scroll_to_y(g_choices, 0, LV_ANIM_OFF);
+	}
+	add_segments(g_text_wrap, n);
+	add_choices(g_choices, n);
+	ui_router::load(ui_router::page_screen());
+#if DISPLAY_BENCHMARK
+	Serial.printf("[STORY] Built node %s in %lu us\n", g_current_node.c_str(),
+				  (unsigned long)(micros() - t0));
+#endif
 }
 
 void ui_story_screen_show(const Story_t &st, const String &nodeKey)
 {
 	g_story = &st;
-	show_node(nodeKey);
+	show_node_at(st.indexOf(nodeKey));
 }
 void ui_story_screen_refresh()
 {
 	if (g_story && g_current_node.length())
-		show_node(g_current_node);
+	{
+		// Fonts or strings changed: rebuild the skeleton too.
+		g_skeleton_story = nullptr;
+		show_node_at(g_story->indexOf(g_current_node));
+	}
+}
+
+lv_obj_t *ui_story_choice_panel()
+{
+	return g_choices;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include <lvgl.h>
 #include "story_engine.h"
 
 // Home
@@ -26,3 +27,6 @@ void ui_splash_screen_show(const char *msg = nullptr);
 // Story reader
 void ui_story_screen_show(const Story_t &story, const String &nodeKey);
 void ui_story_screen_refresh();
+// Container of the current node's choice buttons, or nullptr when the story
+// page is not built (used by the simulator's scripted taps).
+lv_obj_t *ui_story_choice_panel();
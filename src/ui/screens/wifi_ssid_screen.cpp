@@ -51,9 +51,6 @@ static void ssid_back_clicked(lv_event_t *e) {
     scan_btn = nullptr;
     status_label = nullptr;
     
-    extern void ui_app_before_screen_change();
-    ui_app_before_screen_change();
-    
     extern void ui_settings_screen_reset();
     ui_settings_screen_reset();
     
@@ -252,9 +249,6 @@ static void connect_to_selected_network(const String& ssid, const String& passwo
             }
             
             lv_timer_create([](lv_timer_t *return_timer) {
-                extern void ui_app_before_screen_change();
-                ui_app_before_screen_change();
-                
                 extern void ui_settings_screen_reset();
                 ui_settings_screen_reset();
                 
@@ -0,0 +1,253 @@
+// SpscRing on the host: single-threaded semantics, a producer/consumer
+// stress run meant for ThreadSanitizer ([env:native] builds with
+// -fsanitize=thread), and an enqueue/dequeue micro-benchmark against a
+// locked queue that copies a request-sized struct, which is what the
+// FreeRTOS queues did before the rings.
+//
+//   pio test -e native
+#include <unity.h>
+#include "spsc_ring.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+static const int STRESS_ITEMS = 100000;
+
+// Sleeping rather than yielding lets the other side run even on a
+// single-core host.
+static void backoff() {
+    std::this_thread::sleep_for(std::chrono::microseconds(1));
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_push_pop_fifo() {
+    SpscRing<int, 4> ring;
+    TEST_ASSERT_TRUE(ring.empty());
+    for (int i = 0; i < 4; i++) TEST_ASSERT_TRUE(ring.push(int(i)));
+    TEST_ASSERT_EQUAL(4, (int)ring.size());
+
+    int out = -1;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(ring.pop(out));
+        TEST_ASSERT_EQUAL(i, out);
+    }
+    TEST_ASSERT_FALSE(ring.pop(out));
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+static void test_full_ring_leaves_item_untouched() {
+    SpscRing<std::unique_ptr<int>, 2> ring;
+    TEST_ASSERT_TRUE(ring.push(std::make_unique<int>(1)));
+    TEST_ASSERT_TRUE(ring.push(std::make_unique<int>(2)));
+
+    std::unique_ptr<int> extra = std::make_unique<int>(3);
+    TEST_ASSERT_FALSE(ring.push(std::move(extra)));
+    TEST_ASSERT_NOT_NULL(extra.get());
+    TEST_ASSERT_EQUAL(3, *extra);
+}
+
+static void test_wraps_around() {
+    SpscRing<int, 2> ring;
+    int out = -1;
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(ring.push(int(i)));
+        TEST_ASSERT_TRUE(ring.pop(out));
+        TEST_ASSERT_EQUAL(i, out);
+    }
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+static void test_moves_non_trivial_items() {
+    struct Item {
+        std::function<int()> fn;
+        std::unique_ptr<int> value;
+    };
+    SpscRing<Item, 2> ring;
+    int calls = 0;
+    TEST_ASSERT_TRUE(ring.push(Item{[&calls] { return ++calls; }, std::make_unique<int>(7)}));
+
+    Item out;
+    TEST_ASSERT_TRUE(ring.pop(out));
+    TEST_ASSERT_EQUAL(1, out.fn());
+    TEST_ASSERT_EQUAL(7, *out.value);
+}
+
+// One producer thread, one consumer thread, a ring much smaller than the
+// item count so both sides keep hitting the full and empty edges.
+static void test_threaded_stress_keeps_order() {
+    struct Item {
+        std::function<int()> fn;
+        std::unique_ptr<int> value;
+    };
+    SpscRing<Item, 8> ring;
+
+    std::thread producer([&ring] {
+        for (int i = 0; i < STRESS_ITEMS; i++) {
+            Item item{[i] { return i; }, std::make_unique<int>(i)};
+            while (!ring.push(std::move(item))) backoff();
+        }
+    });
+
+    bool ordered = true;
+    for (int i = 0; i < STRESS_ITEMS; i++) {
+        Item item;
+        while (!ring.pop(item)) backoff();
+        if (item.fn() != i || *item.value != i) ordered = false;
+    }
+    producer.join();
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+// The AsyncManager pattern: plain fields of a pooled job are written by
+// one side and only published through the ring that hands the pointer
+// over, in an inbox/outbox round trip.
+static void test_threaded_handle_round_trip() {
+    struct Job {
+        int request = 0;
+        int result = 0;
+        char path[64];
+    };
+    static Job pool[4];
+    SpscRing<Job*, 2> inbox;
+    SpscRing<Job*, 2> outbox;
+
+    std::thread worker([&] {
+        for (int done = 0; done < STRESS_ITEMS;) {
+            Job* job;
+            if (!inbox.pop(job)) {
+                backoff();
+                continue;
+            }
+            job->result = job->request * 2;
+            snprintf(job->path, sizeof(job->path), "/cache/%d", job->request);
+            while (!outbox.push(std::move(job))) backoff();
+            done++;
+        }
+    });
+
+    bool correct = true;
+    int sent = 0;
+    int received = 0;
+    std::deque<Job*> freeJobs;
+    for (Job& job : pool) freeJobs.push_back(&job);
+    while (received < STRESS_ITEMS) {
+        if (sent < STRESS_ITEMS && !freeJobs.empty()) {
+            Job* job = freeJobs.front();
+            job->request = sent;
+            if (inbox.push(std::move(job))) {
+                freeJobs.pop_front();
+                sent++;
+            }
+        }
+        Job* done;
+        if (!outbox.pop(done)) {
+            backoff();
+        } else {
+            char expected[64];
+            snprintf(expected, sizeof(expected), "/cache/%d", done->request);
+            if (done->result != done->request * 2 || strcmp(done->path, expected) != 0) correct = false;
+            freeJobs.push_back(done);
+            received++;
+        }
+    }
+    worker.join();
+    TEST_ASSERT_TRUE(correct);
+}
+
+// ---------------- Benchmark ----------------
+
+// Stand-in for the old OperationRequest: about 400 bytes copied into and
+// out of a locked queue.
+struct CopiedRequest {
+    char url[256];
+    char path[128];
+    int type;
+    void* target;
+};
+
+class LockedQueue {
+public:
+    void send(const CopiedRequest& r) {
+        std::lock_guard<std::mutex> guard(lock_);
+        items_.push_back(r);
+        ready_.notify_one();
+    }
+
+    bool receive(CopiedRequest& r) {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (items_.empty()) return false;
+        memcpy(&r, &items_.front(), sizeof(r));
+        items_.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex lock_;
+    std::condition_variable ready_;
+    std::deque<CopiedRequest> items_;
+};
+
+template <typename F>
+static double ns_per_op(int ops, F body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ops;
+}
+
+static void test_benchmark_enqueue_dequeue() {
+#if defined(__SANITIZE_THREAD__)
+    const int ops = 200000;
+#else
+    const int ops = 5000000;
+#endif
+    static CopiedRequest request;
+    static CopiedRequest received;
+    static int jobs[2];
+
+    SpscRing<int*, 2> ring;
+    double ringNs = ns_per_op(ops, [&] {
+        for (int i = 0; i < ops; i++) {
+            int* job = &jobs[i & 1];
+            ring.push(std::move(job));
+            ring.pop(job);
+        }
+    });
+
+    LockedQueue queue;
+    double queueNs = ns_per_op(ops, [&] {
+        for (int i = 0; i < ops; i++) {
+            request.type = i;
+            queue.send(request);
+            queue.receive(received);
+        }
+    });
+
+    char report[160];
+    snprintf(report, sizeof(report),
+             "push+pop: ring of handles %.1f ns, locked queue of 400-byte copies %.1f ns", ringNs,
+             queueNs);
+    TEST_MESSAGE(report);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_push_pop_fifo);
+    RUN_TEST(test_full_ring_leaves_item_untouched);
+    RUN_TEST(test_wraps_around);
+    RUN_TEST(test_moves_non_trivial_items);
+    RUN_TEST(test_threaded_stress_keeps_order);
+    RUN_TEST(test_threaded_handle_round_trip);
+    RUN_TEST(test_benchmark_enqueue_dequeue);
+    return UNITY_END();
+}
@@ -0,0 +1,444 @@
+// Host benchmark for the story image decoders (ImageDecoder, src/image_decoder.cpp).
+//
+//   make -C tools/decode_bench run      # default: stories/images/adventure
+//
+// The device's decodeFile is compiled unchanged against the simulator's
+// Arduino/SPIFFS shims, with TJpgDec provided by libjpeg (host_jpeg.cpp),
+// so the IDCT scale choice, strip handling and box filter are the shipped
+// code. Times are host times with libjpeg-turbo's SIMD disabled; the ROM
+// decoder on the ESP32 is far slower, so compare columns rather than
+// reading them as device figures.
+//
+// JPEG, for the story box and the library thumbnail box:
+//   shipped   decodeFile: IDCT at 1/2^n, then the box filter
+//   filter    the part of "shipped" spent in the strip copy and box filter
+//   old       file read, full-size decode, then point sampling with a float
+//             scale per pixel (what the decoder did before the box filter)
+//   PSNR      RGB565 output against an exact area-averaged downscale of the
+//             full-size decode
+//   peak      working memory plus output, from the decoder's own log line
+//
+// QOI vs JPEG: file size and decodeFile time for each image as shipped and
+// re-encoded at the story box size, plus a bit-exactness check of the QOI
+// decoder against its source pixels.
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include "config.h"
+#include "image_decoder.h"
+#include "image_pool.h"
+#include "esp32/rom/tjpgd.h"
+#include "host_jpeg.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <dirent.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static const int RUNS = 200;
+static const int FITTED_JPEG_QUALITY = 85;
+
+struct Rgb {
+    std::vector<uint8_t> px;  // RGB888
+    int width = 0;
+    int height = 0;
+};
+
+// ---------------- Helpers ----------------
+
+static std::vector<uint8_t> readHostFile(const std::string& path) {
+    std::vector<uint8_t> data;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return data;
+    uint8_t buf[4096];
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return data;
+}
+
+static bool writeFsFile(const String& path, const std::vector<uint8_t>& data) {
+    File f = SPIFFS.open(path, "w");
+    if (!f) return false;
+    bool ok = f.write(data.data(), data.size()) == data.size();
+    f.close();
+    return ok;
+}
+
+static std::vector<uint8_t> readFsFile(const String& path) {
+    File f = SPIFFS.open(path, "r");
+    std::vector<uint8_t> data(f.size());
+    data.resize(f.read(data.data(), data.size()));
+    f.close();
+    return data;
+}
+
+template <typename F>
+static double medianMs(F body) {
+    std::vector<double> ms;
+    for (int i = 0; i < RUNS; i++) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(ms.begin(), ms.end());
+    return ms[ms.size() / 2];
+}
+
+// Runs body with stdout (the decoder's Serial log) sent to a temp file and
+// returns what was printed.
+template <typename F>
+static std::string captureSerial(F body) {
+    fflush(stdout);
+    FILE* tmp = tmpfile();
+    int saved = dup(STDOUT_FILENO);
+    dup2(fileno(tmp), STDOUT_FILENO);
+    body();
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    std::string text;
+    rewind(tmp);
+    char buf[512];
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), tmp)) > 0;) text.append(buf, n);
+    fclose(tmp);
+    return text;
+}
+
+// Same fit as ImageDecoder: inside the box, aspect kept, never upscaled.
+static void fitSize(int width, int height, int maxWidth, int maxHeight, int& w, int& h) {
+    w = width;
+    h = height;
+    if (width <= maxWidth && height <= maxHeight) return;
+    if (width * maxHeight > height * maxWidth) {
+        w = maxWidth;
+        h = std::max(1, height * maxWidth / width);
+    } else {
+        h = maxHeight;
+        w = std::max(1, width * maxHeight / height);
+    }
+}
+
+static uint16_t to565(const uint8_t* p) {
+    return ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+}
+
+static double psnr(const uint16_t* image, const Rgb& ref) {
+    double err = 0;
+    size_t n = (size_t)ref.width * ref.height;
+    for (size_t i = 0; i < n; i++) {
+        uint16_t v = image[i];
+        int rgb[3] = {(v >> 8) & 0xF8, (v >> 3) & 0xFC, (v << 3) & 0xF8};
+        // Expand 5/6 bits to 8 so a perfect RGB565 copy is not penalised for
+        // its empty low bits.
+        rgb[0] |= rgb[0] >> 5;
+        rgb[1] |= rgb[1] >> 6;
+        rgb[2] |= rgb[2] >> 5;
+        for (int c = 0; c < 3; c++) {
+            double d = rgb[c] - ref.px[i * 3 + c];
+            err += d * d;
+        }
+    }
+    double mse = err / (n * 3);
+    return mse == 0 ? 99.0 : 10 * log10(255.0 * 255.0 / mse);
+}
+
+// ---------------- Reference codecs ----------------
+
+static bool decodeFull(const std::vector<uint8_t>& jpeg, Rgb& out) {
+    return hostDecodeJpeg(jpeg, out.px, out.width, out.height);
+}
+
+// Exact area average: every source pixel contributes its overlap with the
+// destination pixel.
+static Rgb areaDownscale(const Rgb& src, int w, int h) {
+    Rgb out;
+    out.width = w;
+    out.height = h;
+    out.px.resize((size_t)w * h * 3);
+    double sx = (double)src.width / w;
+    double sy = (double)src.height / h;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            double sum[3] = {0, 0, 0};
+            double area = 0;
+            for (int v = (int)(y * sy); v < src.height && v < (y + 1) * sy; v++) {
+                double wy = std::min<double>(v + 1, (y + 1) * sy) - std::max<double>(v, y * sy);
+                for (int u = (int)(x * sx); u < src.width && u < (x + 1) * sx; u++) {
+                    double wx = std::min<double>(u + 1, (x + 1) * sx) - std::max<double>(u, x * sx);
+                    const uint8_t* p = &src.px[((size_t)v * src.width + u) * 3];
+                    for (int c = 0; c < 3; c++) sum[c] += p[c] * wx * wy;
+                    area += wx * wy;
+                }
+            }
+            for (int c = 0; c < 3; c++) out.px[((size_t)y * w + x) * 3 + c] = (uint8_t)lround(sum[c] / area);
+        }
+    }
+    return out;
+}
+
+// The pre-box-filter decoder: every source pixel written to
+// (int)(x * scale), (int)(y * scale); later pixels overwrite earlier ones.
+static std::vector<uint16_t> pointSample(const Rgb& src, int w, int h) {
+    std::vector<uint16_t> out((size_t)w * h, 0xFFFF);
+    float scale = std::min((float)w / src.width, (float)h / src.height);
+    for (int y = 0; y < src.height; y++) {
+        int dy = (int)((float)y * scale);
+        if (dy >= h) continue;
+        for (int x = 0; x < src.width; x++) {
+            int dx = (int)((float)x * scale);
+            if (dx < w) out[(size_t)dy * w + dx] = to565(&src.px[((size_t)y * src.width + x) * 3]);
+        }
+    }
+    return out;
+}
+
+// QOI encoder after the reference implementation (https://qoiformat.org),
+// RGB only.
+static std::vector<uint8_t> encodeQoi(const Rgb& image) {
+    std::vector<uint8_t> out = {'q', 'o', 'i', 'f'};
+    auto be32 = [&out](uint32_t v) {
+        for (int s = 24; s >= 0; s -= 8) out.push_back((uint8_t)(v >> s));
+    };
+    be32(image.width);
+    be32(image.height);
+    out.push_back(3);  // channels
+    out.push_back(0);  // sRGB
+
+    uint8_t index[64][4] = {};
+    uint8_t prev[4] = {0, 0, 0, 255};
+    int run = 0;
+    size_t n = (size_t)image.width * image.height;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t px[4] = {image.px[i * 3], image.px[i * 3 + 1], image.px[i * 3 + 2], 255};
+        if (memcmp(px, prev, 4) == 0) {
+            if (++run == 62 || i == n - 1) {
+                out.push_back(0xC0 | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            out.push_back(0xC0 | (run - 1));
+            run = 0;
+        }
+        int slot = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+        if (memcmp(index[slot], px, 4) == 0) {
+            out.push_back(slot);
+        } else {
+            memcpy(index[slot], px, 4);
+            int8_t vr = px[0] - prev[0];
+            int8_t vg = px[1] - prev[1];
+            int8_t vb = px[2] - prev[2];
+            int8_t vgr = vr - vg;
+            int8_t vgb = vb - vg;
+            if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                out.push_back(0x40 | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+            } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                out.push_back(0x80 | (vg + 32));
+                out.push_back((vgr + 8) << 4 | (vgb + 8));
+            } else {
+                out.push_back(0xFE);
+                out.push_back(px[0]);
+                out.push_back(px[1]);
+                out.push_back(px[2]);
+            }
+        }
+        memcpy(prev, px, 4);
+    }
+    const uint8_t padding[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+    out.insert(out.end(), padding, padding + sizeof(padding));
+    return out;
+}
+
+// ---------------- Benchmarks ----------------
+
+struct Source {
+    std::string name;
+    String fsPath;
+    std::vector<uint8_t> jpeg;
+    Rgb full;
+};
+
+static bool decodeShipped(const String& path, int maxWidth, int maxHeight, ImageDecoder::DecodedImage& out) {
+    return ImageDecoder::decodeFile(path, maxWidth, maxHeight, out);
+}
+
+static void benchJpeg(const std::vector<Source>& sources, const char* label, int maxWidth, int maxHeight) {
+    printf("\nJPEG, %s box %dx%d (median of %d runs)\n", label, maxWidth, maxHeight, RUNS);
+    printf("%-8s %9s %6s %11s %10s %8s %10s %8s %8s\n", "image", "size", "IDCT", "shipped ms",
+           "filter ms", "old ms", "peak B", "PSNR", "old PSNR");
+
+    double sumShipped = 0, sumOld = 0, sumFilter = 0, sumPsnr = 0, sumOldPsnr = 0;
+    int counted = 0;
+    for (const Source& s : sources) {
+        int w, h;
+        fitSize(s.full.width, s.full.height, maxWidth, maxHeight, w, h);
+        char dims[16];
+        snprintf(dims, sizeof(dims), "%dx%d", s.full.width, s.full.height);
+
+        ImageDecoder::DecodedImage image;
+        std::string log = captureSerial([&] { decodeShipped(s.fsPath, maxWidth, maxHeight, image); });
+        if (!image.pixels) {
+            printf("%-8s %9s  unsupported by TJpgDec (%s)\n", s.name.c_str(), dims,
+                   log.find("(8)") != std::string::npos ? "progressive" : "decode error");
+            continue;
+        }
+        Rgb ref = areaDownscale(s.full, w, h);
+        double quality = psnr(image.pixels, ref);
+        ImageDecoder::release(image);
+
+        unsigned idct = 1, peak = 0;
+        size_t at = log.find("(IDCT 1/");
+        if (at != std::string::npos) sscanf(log.c_str() + at, "(IDCT 1/%u)", &idct);
+        at = log.find("peak ");
+        if (at != std::string::npos) sscanf(log.c_str() + at, "peak %u", &peak);
+
+        jd_take_output_us();
+        double shippedMs;
+        captureSerial([&] {
+            shippedMs = medianMs([&] {
+                decodeShipped(s.fsPath, maxWidth, maxHeight, image);
+                ImageDecoder::release(image);
+            });
+        });
+        double filterMs = jd_take_output_us() / 1000.0 / RUNS;
+
+        std::vector<uint16_t> old;
+        double oldMs = medianMs([&] {
+            Rgb full;
+            decodeFull(readFsFile(s.fsPath), full);
+            old = pointSample(full, w, h);
+        });
+        double oldQuality = psnr(old.data(), ref);
+
+        printf("%-8s %9s %6s %11.3f %10.3f %8.3f %10u %7.2f %8.2f\n", s.name.c_str(), dims,
+               ("1/" + std::to_string(idct)).c_str(), shippedMs, filterMs, oldMs, peak, quality, oldQuality);
+        sumShipped += shippedMs;
+        sumFilter += filterMs;
+        sumOld += oldMs;
+        sumPsnr += quality;
+        sumOldPsnr += oldQuality;
+        counted++;
+    }
+    if (counted) {
+        printf("%-8s %9s %6s %11.3f %10.3f %8.3f %10s %7.2f %8.2f\n", "mean", "", "", sumShipped / counted,
+               sumFilter / counted, sumOld / counted, "", sumPsnr / counted, sumOldPsnr / counted);
+    }
+}
+
+static void benchQoi(const std::vector<Source>& sources, int maxWidth, int maxHeight) {
+    printf("\nQOI vs JPEG through decodeFile, story box %dx%d (median of %d runs)\n", maxWidth, maxHeight, RUNS);
+    printf("%-8s | %8s %8s %9s %9s | %8s %8s %9s %9s %6s\n", "image", "JPEG B", "QOI B", "JPEG ms",
+           "QOI ms", "JPEG B", "QOI B", "JPEG ms", "QOI ms", "exact");
+    printf("%-8s | %-37s | %-44s\n", "", "as shipped (full size)", "re-encoded at box size");
+
+    double sums[8] = {0};
+    int counted = 0;
+    bool allExact = true;
+    for (const Source& s : sources) {
+        int w, h;
+        fitSize(s.full.width, s.full.height, maxWidth, maxHeight, w, h);
+        Rgb fitted = areaDownscale(s.full, w, h);
+
+        std::vector<uint8_t> qoiFull = encodeQoi(s.full);
+        std::vector<uint8_t> qoiFit = encodeQoi(fitted);
+        std::vector<uint8_t> jpegFit = hostEncodeJpeg(fitted.px.data(), fitted.width, fitted.height, FITTED_JPEG_QUALITY);
+        String base = "/bench/" + String(s.name.substr(0, s.name.rfind('.')).c_str());
+        writeFsFile(base + ".qoi", qoiFull);
+        writeFsFile(base + "_fit.qoi", qoiFit);
+        writeFsFile(base + "_fit.jpg", jpegFit);
+
+        // Output must equal the encoder's input, converted to RGB565.
+        ImageDecoder::DecodedImage image;
+        captureSerial([&] { decodeShipped(base + "_fit.qoi", maxWidth, maxHeight, image); });
+        bool exact = image.pixels && image.width == w && image.height == h;
+        for (int i = 0; exact && i < w * h; i++) exact = image.pixels[i] == to565(&fitted.px[(size_t)i * 3]);
+        ImageDecoder::release(image);
+        allExact = allExact && exact;
+
+        auto timed = [&](const String& path) {
+            double ms = 0;
+            bool ok = true;
+            captureSerial([&] {
+                ms = medianMs([&] {
+                    ok = decodeShipped(path, maxWidth, maxHeight, image) && ok;
+                    ImageDecoder::release(image);
+                });
+            });
+            return ok ? ms : NAN;
+        };
+        double jpegMs = timed(s.fsPath);
+        double qoiMs = timed(base + ".qoi");
+        double jpegFitMs = timed(base + "_fit.jpg");
+        double qoiFitMs = timed(base + "_fit.qoi");
+
+        printf("%-8s | %8zu %8zu %9.3f %9.3f | %8zu %8zu %9.3f %9.3f %6s\n", s.name.c_str(), s.jpeg.size(),
+               qoiFull.size(), jpegMs, qoiMs, jpegFit.size(), qoiFit.size(), jpegFitMs, qoiFitMs,
+               exact ? "yes" : "NO");
+        if (std::isnan(jpegMs)) continue;
+        double row[8] = {(double)s.jpeg.size(), (double)qoiFull.size(), jpegMs, qoiMs,
+                         (double)jpegFit.size(), (double)qoiFit.size(), jpegFitMs, qoiFitMs};
+        for (int i = 0; i < 8; i++) sums[i] += row[i];
+        counted++;
+    }
+    if (counted) {
+        printf("%-8s | %8.0f %8.0f %9.3f %9.3f | %8.0f %8.0f %9.3f %9.3f %6s\n", "mean", sums[0] / counted,
+               sums[1] / counted, sums[2] / counted, sums[3] / counted, sums[4] / counted, sums[5] / counted,
+               sums[6] / counted, sums[7] / counted, allExact ? "yes" : "NO");
+        printf("(means over the images TJpgDec accepts; JPEG at box size is quality %d)\n", FITTED_JPEG_QUALITY);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : "stories/images/adventure";
+    // The ROM decoder is plain C; keep libjpeg-turbo off its SIMD paths so
+    // JPEG is not flattered against the scalar QOI decoder.
+    setenv("JSIMD_FORCENONE", "1", 0);
+
+    char root[] = "/tmp/decode-bench-XXXXXX";
+    if (!mkdtemp(root)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    SPIFFS.setRoot(root);
+    SPIFFS.begin(true);
+    captureSerial([] { ImagePool::init(); });
+
+    std::vector<std::string> names;
+    if (DIR* d = opendir(dir.c_str())) {
+        while (dirent* e = readdir(d)) {
+            std::string name = e->d_name;
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".jpg") == 0) names.push_back(name);
+        }
+        closedir(d);
+    }
+    std::sort(names.begin(), names.end(), [](const std::string& a, const std::string& b) {
+        return atoi(a.c_str()) != atoi(b.c_str()) ? atoi(a.c_str()) < atoi(b.c_str()) : a < b;
+    });
+    if (names.empty()) {
+        fprintf(stderr, "no .jpg files in %s\n", dir.c_str());
+        return 1;
+    }
+
+    std::vector<Source> sources;
+    for (const std::string& name : names) {
+        Source s;
+        s.name = name;
+        s.jpeg = readHostFile(dir + "/" + name);
+        s.fsPath = "/bench/" + String(name.c_str());
+        if (!decodeFull(s.jpeg, s.full) || !writeFsFile(s.fsPath, s.jpeg)) {
+            fprintf(stderr, "skipping unreadable %s\n", name.c_str());
+            continue;
+        }
+        sources.push_back(std::move(s));
+    }
+
+    benchJpeg(sources, "story", STORY_IMAGE_MAX_WIDTH, STORY_IMAGE_MAX_HEIGHT);
+    benchJpeg(sources, "thumbnail", THUMB_WIDTH, THUMB_HEIGHT);
+    benchQoi(sources, STORY_IMAGE_MAX_WIDTH, STORY_IMAGE_MAX_HEIGHT);
+    return 0;
+}
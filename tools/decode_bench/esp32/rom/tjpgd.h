@@ -0,0 +1,42 @@
+// The ESP32 ROM TJpgDec API implemented on the host's libjpeg, so the
+// benchmark runs the device's decodeJpegFile unchanged. Like the ROM
+// decoder it accepts baseline JPEGs only, hands out RGB888 blocks one MCU
+// at a time in raster order, and scales by 1/2^scale in the IDCT.
+#pragma once
+
+#include <cstdint>
+
+typedef unsigned int UINT;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+
+typedef enum {
+    JDR_OK = 0,
+    JDR_INTR,
+    JDR_INP,
+    JDR_MEM1,
+    JDR_MEM2,
+    JDR_PAR,
+    JDR_FMT1,
+    JDR_FMT2,
+    JDR_FMT3
+} JRESULT;
+
+typedef struct {
+    WORD left, right, top, bottom;
+} JRECT;
+
+typedef struct JDEC JDEC;
+struct JDEC {
+    BYTE msx, msy;
+    WORD width, height;
+    void* device;
+    void* host;  // libjpeg state, owned by the adapter
+};
+
+JRESULT jd_prepare(JDEC* jd, UINT (*infunc)(JDEC*, BYTE*, UINT), void* pool, UINT size, void* device);
+JRESULT jd_decomp(JDEC* jd, UINT (*outfunc)(JDEC*, void*, JRECT*), BYTE scale);
+
+// Benchmark only: microseconds spent inside outfunc (the strip copy and box
+// filter) since the last call.
+uint64_t jd_take_output_us();
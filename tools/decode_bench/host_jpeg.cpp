@@ -0,0 +1,205 @@
+// Everything that touches libjpeg, kept out of the files that include
+// Arduino.h (both define `boolean`): TJpgDec for the benchmark, see
+// esp32/rom/tjpgd.h, and the full-size reference codec.
+#include "esp32/rom/tjpgd.h"
+#include "host_jpeg.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <jpeglib.h>
+
+struct HostDecoder {
+    jpeg_decompress_struct cinfo;
+    jpeg_error_mgr err;
+    std::jmp_buf fail;
+    std::vector<BYTE> data;
+};
+
+static uint64_t outputUs = 0;
+
+static void onError(j_common_ptr cinfo) {
+    std::longjmp(((HostDecoder*)cinfo->client_data)->fail, 1);
+}
+
+static void destroy(JDEC* jd) {
+    HostDecoder* host = (HostDecoder*)jd->host;
+    if (!host) return;
+    jpeg_destroy_decompress(&host->cinfo);
+    delete host;
+    jd->host = nullptr;
+}
+
+JRESULT jd_prepare(JDEC* jd, UINT (*infunc)(JDEC*, BYTE*, UINT), void*, UINT, void* device) {
+    jd->device = device;
+    jd->host = nullptr;
+
+    // The whole stream is read up front; the ROM decoder pulls it in
+    // 512-byte chunks through the same callback.
+    std::vector<BYTE> data;
+    BYTE chunk[512];
+    for (UINT n; (n = infunc(jd, chunk, sizeof(chunk))) > 0;) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+
+    HostDecoder* host = new HostDecoder();
+    host->data.swap(data);
+    host->cinfo.err = jpeg_std_error(&host->err);
+    host->err.error_exit = onError;
+    host->cinfo.client_data = host;
+    jpeg_create_decompress(&host->cinfo);
+    jd->host = host;
+
+    if (setjmp(host->fail)) {
+        destroy(jd);
+        return JDR_FMT1;
+    }
+    jpeg_mem_src(&host->cinfo, host->data.data(), host->data.size());
+    jpeg_read_header(&host->cinfo, TRUE);
+    if (host->cinfo.progressive_mode || host->cinfo.arith_code) {
+        destroy(jd);
+        return JDR_FMT3;
+    }
+
+    jd->width = host->cinfo.image_width;
+    jd->height = host->cinfo.image_height;
+    jd->msx = host->cinfo.max_h_samp_factor;
+    jd->msy = host->cinfo.max_v_samp_factor;
+    return JDR_OK;
+}
+
+JRESULT jd_decomp(JDEC* jd, UINT (*outfunc)(JDEC*, void*, JRECT*), BYTE scale) {
+    HostDecoder* host = (HostDecoder*)jd->host;
+    if (!host) return JDR_PAR;
+    jpeg_decompress_struct& cinfo = host->cinfo;
+
+    JRESULT result = JDR_OK;
+    if (setjmp(host->fail)) {
+        destroy(jd);
+        return JDR_FMT1;
+    }
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = 1u << scale;
+    cinfo.out_color_space = JCS_RGB;
+    cinfo.dct_method = JDCT_ISLOW;
+    jpeg_start_decompress(&cinfo);
+
+    // Block geometry follows the ROM decoder's mcu_output(): each MCU of
+    // mx x my source pixels (clipped to the image) becomes a block of
+    // (size >> scale) pixels, at least one, at (x >> scale, y >> scale). So
+    // when the size is not a multiple of the scaled MCU the last block of a
+    // row reaches past width >> scale, into the column libjpeg rounds up to.
+    UINT mx = jd->msx * 8u;
+    UINT my = jd->msy * 8u;
+    UINT mcuWidth = mx >> scale;
+    UINT mcuHeight = my >> scale;
+
+    size_t rowBytes = (size_t)cinfo.output_width * 3;
+    std::vector<BYTE> strip(rowBytes * mcuHeight);
+    std::vector<BYTE> block((size_t)mcuWidth * mcuHeight * 3);
+
+    for (UINT y = 0; y < jd->height && result == JDR_OK; y += my) {
+        UINT top = y >> scale;
+        UINT rows = std::min(my, jd->height - y) >> scale;
+        if (rows == 0) rows = 1;
+        for (UINT n = 0; n < rows && cinfo.output_scanline < cinfo.output_height;) {
+            JSAMPROW line = strip.data() + rowBytes * n;
+            n += jpeg_read_scanlines(&cinfo, &line, 1);
+        }
+
+        for (UINT x = 0; x < jd->width; x += mx) {
+            UINT left = x >> scale;
+            UINT cols = std::min(mx, jd->width - x) >> scale;
+            if (cols == 0) cols = 1;
+            for (UINT r = 0; r < rows; r++) {
+                const BYTE* src = strip.data() + rowBytes * r + left * 3;
+                std::copy(src, src + cols * 3, block.data() + (size_t)r * cols * 3);
+            }
+            JRECT rect = {(WORD)left, (WORD)(left + cols - 1), (WORD)top, (WORD)(top + rows - 1)};
+
+            auto start = std::chrono::steady_clock::now();
+            UINT keepGoing = outfunc(jd, block.data(), &rect);
+            outputUs += std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+            if (!keepGoing) {
+                result = JDR_INTR;
+                break;
+            }
+        }
+    }
+
+    if (result == JDR_OK) {
+        while (cinfo.output_scanline < cinfo.output_height) {
+            BYTE* line = strip.data();
+            jpeg_read_scanlines(&cinfo, &line, 1);
+        }
+        jpeg_finish_decompress(&cinfo);
+    } else {
+        jpeg_abort_decompress(&cinfo);
+    }
+    destroy(jd);
+    return result;
+}
+
+uint64_t jd_take_output_us() {
+    uint64_t us = outputUs;
+    outputUs = 0;
+    return us;
+}
+
+// ---------------- Reference codec ----------------
+
+bool hostDecodeJpeg(const std::vector<uint8_t>& jpeg, std::vector<uint8_t>& rgb, int& width, int& height) {
+    jpeg_decompress_struct cinfo;
+    jpeg_error_mgr err;
+    cinfo.err = jpeg_std_error(&err);
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, jpeg.data(), jpeg.size());
+    if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    width = cinfo.output_width;
+    height = cinfo.output_height;
+    rgb.resize((size_t)width * height * 3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = rgb.data() + (size_t)cinfo.output_scanline * width * 3;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+std::vector<uint8_t> hostEncodeJpeg(const uint8_t* rgb, int width, int height, int quality) {
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr err;
+    cinfo.err = jpeg_std_error(&err);
+    jpeg_create_compress(&cinfo);
+    unsigned char* buf = nullptr;
+    unsigned long len = 0;
+    jpeg_mem_dest(&cinfo, &buf, &len);
+    cinfo.image_width = width;
+    cinfo.image_height = height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE);
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = (JSAMPROW)rgb + (size_t)cinfo.next_scanline * width * 3;
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    std::vector<uint8_t> data(buf, buf + len);
+    free(buf);
+    return data;
+}
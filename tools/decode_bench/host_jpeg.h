@@ -0,0 +1,10 @@
+// Full-size libjpeg decode and encode for the benchmark's reference images.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Baseline or progressive JPEG to RGB888; false on a corrupt stream.
+bool hostDecodeJpeg(const std::vector<uint8_t>& jpeg, std::vector<uint8_t>& rgb, int& width, int& height);
+
+std::vector<uint8_t> hostEncodeJpeg(const uint8_t* rgb, int width, int height, int quality);
@@ -0,0 +1,21 @@
+// The LVGL image-header definitions image_decoder.cpp uses for .bin cache
+// files (LVGL 9.2 layout). The benchmark does not link LVGL.
+#pragma once
+
+#include <stdint.h>
+
+#define LV_IMAGE_HEADER_MAGIC 0x19
+
+typedef enum {
+    LV_COLOR_FORMAT_RGB565 = 0x12
+} lv_color_format_t;
+
+typedef struct {
+    uint32_t magic : 8;
+    uint32_t cf : 8;
+    uint32_t flags : 16;
+    uint32_t w : 16;
+    uint32_t h : 16;
+    uint32_t stride : 16;
+    uint32_t reserved_2 : 16;
+} lv_image_header_t;
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Model LVGL partial rendering with one or two draw buffers.
+
+Splits a dirty area into DRAW_BUF_SIZE strips and replays render, byte swap
+and SPI transfer for each strip. With one buffer every step is serial; with
+two, a strip renders while the previous one is still on the wire. Prints the
+frame time of both modes and how much of the transfer time overlapped
+rendering.
+
+Render cost per pixel depends on the screen content; measure it on the
+device for the screen of interest and pass it with --render-ns.
+
+    tools/flush_sim.py --render-ns 120 --height 276
+
+Model output for the story content area (240x276, 32-row buffers, 55 MHz),
+not device measurements:
+
+    render ns/px    single ms    double ms    speedup    overlap
+              50        22.58        19.68      1.15x        16%
+             100        25.89        20.07      1.29x        32%
+             200        32.52        20.84      1.56x        62%
+             300        39.14        22.31      1.75x        89%
+             500        52.39        34.78      1.51x        93%
+"""
+
+import argparse
+
+
+def simulate(strips, render_us, swap_us, xfer_us, buffers):
+    """Return (frame_us, overlapped_us) for the given strip pixel counts."""
+    renders = []         # (start, end) CPU time per strip
+    transfers = []       # (start, end) bus time per strip
+    for i, px in enumerate(strips):
+        start = renders[-1][1] if renders else 0.0
+        # The buffer for this strip is free once the transfer that used it
+        # (buffers strips ago) has completed.
+        if i >= buffers:
+            start = max(start, transfers[i - buffers][1])
+        done = start + px * (render_us + swap_us)
+        renders.append((start, done))
+        # Only one transfer on the bus at a time.
+        xfer_start = max(done, transfers[-1][1] if transfers else 0.0)
+        transfers.append((xfer_start, xfer_start + px * xfer_us))
+
+    overlapped = 0.0
+    for xs, xe in transfers:
+        for rs, re in renders:
+            overlapped += max(0.0, min(xe, re) - max(xs, rs))
+    return transfers[-1][1], overlapped
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--width", type=int, default=240, help="dirty area width (px)")
+    ap.add_argument("--height", type=int, default=320, help="dirty area height (px)")
+    ap.add_argument("--buf-rows", type=int, default=32,
+                    help="rows per draw buffer (DRAW_BUF_SIZE / width / 2)")
+    ap.add_argument("--spi-mhz", type=float, default=55.0, help="SPI_FREQUENCY")
+    ap.add_argument("--render-ns", type=float, default=100.0, help="render cost per pixel")
+    ap.add_argument("--swap-ns", type=float, default=4.0,
+                    help="lv_draw_sw_rgb565_swap cost per pixel (DMA mode only)")
+    args = ap.parse_args()
+
+    strips = []
+    rows = args.height
+    while rows > 0:
+        n = min(rows, args.buf_rows)
+        strips.append(n * args.width)
+        rows -= n
+
+    render_us = args.render_ns / 1000.0
+    xfer_us = 16.0 / args.spi_mhz  # 16 bits per pixel
+    xfer_total = sum(strips) * xfer_us
+
+    # Single buffer: lv_tft_espi swaps while pushing, so no separate pass.
+    single, _ = simulate(strips, render_us, 0.0, xfer_us, 1)
+    double, overlapped = simulate(strips, render_us, args.swap_ns / 1000.0, xfer_us, 2)
+
+    print(f"{len(strips)} strips, {sum(strips)} px, transfer {xfer_total / 1000:.2f} ms")
+    print(f"single buffer: {single / 1000:.2f} ms")
+    print(f"double buffer: {double / 1000:.2f} ms ({single / double:.2f}x)")
+    print(f"overlap: {overlapped / xfer_total:.0%} of transfer time hidden behind rendering")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Convert an image into an LVGL 9 C asset sized exactly for the display.
+
+    python tools/img2c.py splash.png --name image_splash -o src/ui/images/image_splash.c
+
+The output is RGB565 in the MCU's native (little-endian) byte order, which
+is what LVGL renders. The image is scaled to cover SCREEN_WIDTH x
+SCREEN_HEIGHT and center-cropped, so the widget shows it 1:1. There is no
+lv_image_set_scale() and no transform path on redraw. The array is const,
+so it stays in flash and is read in place: no decode step and no RAM copy
+before the first frame.
+
+The input can be a PNG/JPEG (needs Pillow) or an existing LVGL RGB565 C
+array. A C array larger than the screen is only cropped, so Pillow is not
+needed to re-fit the assets already in the tree.
+
+--report prints what RLE compression would save. Compression is
+deliberately not emitted: LVGL would have to decompress each background
+into a 150 KB heap buffer, which an ESP32 without PSRAM cannot spare next
+to the image slabs. The uncompressed array in flash costs no RAM and
+no decode time.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+SCREEN_WIDTH = 240
+SCREEN_HEIGHT = 320
+
+
+def load_c_array(path):
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    if "LV_COLOR_FORMAT_RGB565" not in text:
+        sys.exit("%s: only RGB565 C arrays are supported" % path)
+    w = int(re.search(r"\.header\.w\s*=\s*(\d+)", text).group(1))
+    h = int(re.search(r"\.header\.h\s*=\s*(\d+)", text).group(1))
+    body = text[text.index("[] = {"):text.index("};")]
+    data = bytes(int(b, 16) for b in re.findall(r"0x([0-9a-fA-F]{2})", body))
+    if len(data) != w * h * 2:
+        sys.exit("%s: %d bytes for %dx%d" % (path, len(data), w, h))
+    return w, h, data
+
+
+def crop_rgb565(w, h, data, out_w, out_h):
+    if w < out_w or h < out_h:
+        sys.exit("C array input is %dx%d; upscaling needs the original image" % (w, h))
+    x0 = (w - out_w) // 2
+    y0 = (h - out_h) // 2
+    rows = []
+    for y in range(y0, y0 + out_h):
+        start = (y * w + x0) * 2
+        rows.append(data[start:start + out_w * 2])
+    return b"".join(rows)
+
+
+def load_image(path, out_w, out_h):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("Pillow is required for image input (pip install pillow)")
+    img = Image.open(path).convert("RGB")
+    scale = max(out_w / img.width, out_h / img.height)
+    size = (max(out_w, round(img.width * scale)), max(out_h, round(img.height * scale)))
+    if size != img.size:
+        img = img.resize(size, Image.LANCZOS)
+    x0 = (img.width - out_w) // 2
+    y0 = (img.height - out_h) // 2
+    img = img.crop((x0, y0, x0 + out_w, y0 + out_h))
+    out = bytearray()
+    for r, g, b in img.getdata():
+        v = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+        out += bytes((v & 0xFF, v >> 8))
+    return bytes(out)
+
+
+def rle_size(data, block=2):
+    """Size of LVGL's RLE encoding (runs and literals of up to 127 blocks)."""
+    blocks = [data[i:i + block] for i in range(0, len(data), block)]
+    size = i = 0
+    while i < len(blocks):
+        run = 1
+        while i + run < len(blocks) and run < 127 and blocks[i + run] == blocks[i]:
+            run += 1
+        if run > 1:
+            size += 1 + block
+            i += run
+            continue
+        lit = 1
+        while (i + lit < len(blocks) and lit < 127 and
+               (i + lit + 1 >= len(blocks) or blocks[i + lit] != blocks[i + lit + 1])):
+            lit += 1
+        size += 1 + lit * block
+        i += lit
+    return size
+
+
+def write_c(path, name, w, h, data):
+    attr = "LV_ATTRIBUTE_IMAGE_" + name.upper()
+    lines = [
+        "#ifdef __has_include",
+        "    #if __has_include(\"lvgl.h\")",
+        "        #ifndef LV_LVGL_H_INCLUDE_SIMPLE",
+        "            #define LV_LVGL_H_INCLUDE_SIMPLE",
+        "        #endif",
+        "    #endif",
+        "#endif",
+        "",
+        "#if defined(LV_LVGL_H_INCLUDE_SIMPLE)",
+        "    #include \"lvgl.h\"",
+        "#else",
+        "    #include \"lvgl/lvgl.h\"",
+        "#endif",
+        "",
+        "",
+        "#ifndef LV_ATTRIBUTE_MEM_ALIGN",
+        "#define LV_ATTRIBUTE_MEM_ALIGN",
+        "#endif",
+        "",
+        "#ifndef %s" % attr,
+        "#define %s" % attr,
+        "#endif",
+        "",
+        "const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST %s uint8_t %s_map[] = {" % (attr, name),
+    ]
+    stride = w * 2
+    for y in range(h):
+        row = data[y * stride:(y + 1) * stride]
+        lines.append("  " + "".join("0x%02x, " % b for b in row))
+    lines += [
+        "};",
+        "",
+        "const lv_image_dsc_t %s = {" % name,
+        "  .header.cf = LV_COLOR_FORMAT_RGB565,",
+        "  .header.magic = LV_IMAGE_HEADER_MAGIC,",
+        "  .header.w = %d," % w,
+        "  .header.h = %d," % h,
+        "  .data_size = %d * 2," % (w * h),
+        "  .data = %s_map," % name,
+        "};",
+        "",
+    ]
+    with open(path, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("input", help="PNG/JPEG, or an LVGL RGB565 .c array")
+    ap.add_argument("--name", help="C symbol (default: output file name)")
+    ap.add_argument("-o", "--output", help="C file to write (default: report only)")
+    ap.add_argument("--width", type=int, default=SCREEN_WIDTH)
+    ap.add_argument("--height", type=int, default=SCREEN_HEIGHT)
+    ap.add_argument("--report", action="store_true", help="print raw and RLE sizes")
+    args = ap.parse_args()
+
+    if args.input.endswith(".c"):
+        w, h, data = load_c_array(args.input)
+        if (w, h) != (args.width, args.height):
+            print("[img2c] cropping %dx%d to %dx%d" % (w, h, args.width, args.height))
+        data = crop_rgb565(w, h, data, args.width, args.height)
+    else:
+        data = load_image(args.input, args.width, args.height)
+
+    if args.output:
+        name = args.name or os.path.splitext(os.path.basename(args.output))[0]
+        write_c(args.output, name, args.width, args.height, data)
+        print("[img2c] wrote %s: %dx%d RGB565, %d bytes" % (args.output, args.width, args.height, len(data)))
+    if args.report or not args.output:
+        rle = rle_size(data)
+        print("[img2c] raw %d bytes, RLE %d bytes (%.0f%%)" % (len(data), rle, 100.0 * rle / len(data)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,9 @@
+"""Link [env:native] tests against ThreadSanitizer (PlatformIO pre-script).
+
+build_flags only reach the compiler for -fsanitize, so the runtime is
+added to the link line here as well.
+"""
+
+Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+
+env.Append(CCFLAGS=["-fsanitize=thread", "-g"], LINKFLAGS=["-fsanitize=thread"])  # noqa: F821
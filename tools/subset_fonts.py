@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Generate subsetted, compressed UI fonts (PlatformIO pre-script).
+
+Collects the characters used by the UI strings in src/i18n.cpp and the
+bundled stories in stories/, adds printable ASCII and the letters of the UI
+languages (downloaded stories are not known at build time) plus LVGL's symbol
+glyphs, and runs lv_font_conv once per UI size into
+src/ui/fonts/generated/subset_<size>.c with RLE compression.
+
+When that succeeds the build gets KIDDO_SUBSET_FONTS, which switches
+ui/fonts.h and lv_conf.h from the hand-made accent fonts plus built-in
+Montserrat fallbacks to the generated fonts only. Without lv_font_conv
+(npm i -g lv_font_conv) or the Montserrat/FontAwesome sources shipped in
+LVGL's scripts/built_in_font/, the build keeps the existing fonts; any
+fonts generated by an earlier build are deleted then, since everything under
+src/ is compiled in.
+
+Also runs standalone (python tools/subset_fonts.py) to regenerate and print
+the size report.
+"""
+
+import hashlib
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+SIZES = (12, 14, 16, 20)
+DROPPED_BUILTINS = (8, 10, 18, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48)
+
+# Same symbol set LVGL's built-in Montserrat fonts carry (LV_SYMBOL_*); widgets
+# such as the keyboard and dropdown use them without the app naming them.
+SYMBOL_RANGE = (
+    "61441,61448,61451,61452,61453,61457,61459,61461,61465,61468,61473,61478,"
+    "61479,61480,61502,61507,61512,61515,61516,61517,61521,61522,61523,61524,"
+    "61543,61544,61550,61552,61553,61556,61559,61560,61561,61563,61587,61589,"
+    "61636,61637,61639,61641,61664,61671,61674,61683,61724,61732,61787,61931,"
+    "62016,62017,62018,62019,62020,62087,62099,62212,62189,62810,63426,63650"
+)
+
+
+# Letters of the languages the UI offers (i18n.h) and common typographic
+# punctuation, since stories downloaded later are not known at build time.
+LANGUAGE_GLYPHS = "áàâãéêíóôõúçÁÀÂÃÉÊÍÓÔÕÚÇ" + "“”‘’–—…«»"
+
+
+def project_dir(env=None):
+    if env is not None:
+        return env.subst("$PROJECT_DIR")
+    return os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def collect_glyphs(root):
+    chars = {chr(c) for c in range(0x20, 0x7F)}
+    chars.update(LANGUAGE_GLYPHS)
+    with open(os.path.join(root, "src", "i18n.cpp"), encoding="utf-8") as f:
+        for literal in re.findall(r'"((?:[^"\\]|\\.)*)"', f.read()):
+            chars.update(literal)
+    stories = os.path.join(root, "stories")
+    for name in sorted(os.listdir(stories)) if os.path.isdir(stories) else []:
+        if name.endswith(".json"):
+            with open(os.path.join(stories, name), encoding="utf-8") as f:
+                chars.update(f.read())
+    return "".join(sorted(c for c in chars if c.isprintable()))
+
+
+def find_lvgl(root):
+    libdeps = os.path.join(root, ".pio", "libdeps")
+    if not os.path.isdir(libdeps):
+        return None
+    for env_dir in os.listdir(libdeps):
+        path = os.path.join(libdeps, env_dir, "lvgl")
+        if os.path.isdir(path):
+            return path
+    return None
+
+
+def table_bytes(path):
+    """Approximate const data in a generated LVGL font (one byte per 0x..)."""
+    if not os.path.isfile(path):
+        return 0
+    with open(path, encoding="utf-8", errors="ignore") as f:
+        return len(re.findall(r"0x[0-9a-fA-F]{2}\b", f.read()))
+
+
+def remove_generated(out_dir):
+    """Delete outputs of an earlier run so they are not built next to the
+    bundled fonts, and so a partial run is not taken as up to date."""
+    if os.path.isdir(out_dir):
+        print("[fonts] removing stale %s" % os.path.relpath(out_dir))
+        shutil.rmtree(out_dir)
+
+
+def generate(root, glyphs, lvgl):
+    out_dir = os.path.join(root, "src", "ui", "fonts", "generated")
+    converter = shutil.which("lv_font_conv")
+    fonts = os.path.join(lvgl, "scripts", "built_in_font") if lvgl else ""
+    text_font = os.path.join(fonts, "Montserrat-Medium.ttf")
+    symbol_font = os.path.join(fonts, "FontAwesome5-Solid+Brands+Regular.woff")
+    if not converter or not os.path.isfile(text_font) or not os.path.isfile(symbol_font):
+        print("[fonts] lv_font_conv or font sources missing; keeping the bundled fonts")
+        remove_generated(out_dir)
+        return False
+
+    os.makedirs(out_dir, exist_ok=True)
+    stamp = os.path.join(out_dir, ".glyphs")
+    digest = hashlib.sha1(glyphs.encode("utf-8")).hexdigest()
+    outputs = [os.path.join(out_dir, "subset_%d.c" % size) for size in SIZES]
+    if os.path.isfile(stamp) and all(map(os.path.isfile, outputs)):
+        with open(stamp) as f:
+            if f.read().strip() == digest:
+                return True
+
+    for size, out in zip(SIZES, outputs):
+        cmd = [converter, "--bpp", "4", "--size", str(size), "--format", "lvgl",
+               "--font", text_font, "--symbols", glyphs,
+               "--font", symbol_font, "--range", SYMBOL_RANGE,
+               "-o", out]
+        if subprocess.call(cmd) != 0:
+            print("[fonts] lv_font_conv failed for size %d; keeping the bundled fonts" % size)
+            remove_generated(out_dir)
+            return False
+    with open(stamp, "w") as f:
+        f.write(digest + "\n")
+    return True
+
+
+def report(root, glyphs, lvgl, subset):
+    print("[fonts] %d text glyphs" % len(glyphs))
+    if lvgl:
+        builtin = os.path.join(lvgl, "src", "font")
+        dropped = sum(table_bytes(os.path.join(builtin, "lv_font_montserrat_%d.c" % s))
+                      for s in DROPPED_BUILTINS)
+        print("[fonts] unused built-in Montserrat sizes dropped: ~%d KB" % (dropped // 1024))
+        if subset:
+            replaced = sum(table_bytes(os.path.join(builtin, "lv_font_montserrat_%d.c" % s))
+                           for s in SIZES)
+            replaced += sum(table_bytes(os.path.join(root, "src", "ui", "fonts", "montserrat_%d.c" % s))
+                            for s in SIZES)
+            generated = sum(table_bytes(os.path.join(root, "src", "ui", "fonts", "generated",
+                                                     "subset_%d.c" % s)) for s in SIZES)
+            print("[fonts] UI fonts: ~%d KB full -> ~%d KB subset" % (replaced // 1024, generated // 1024))
+
+
+def run(env=None):
+    root = project_dir(env)
+    glyphs = collect_glyphs(root)
+    lvgl = find_lvgl(root)
+    subset = generate(root, glyphs, lvgl)
+    report(root, glyphs, lvgl, subset)
+    if env is not None and subset:
+        # The hand-made accent fonts fall back to built-ins that are now off.
+        env.Append(CPPDEFINES=["KIDDO_SUBSET_FONTS"] +
+                   [("MONTSERRAT_%d" % s, 0) for s in SIZES])
+    return subset
+
+
+if __name__ == "__main__":
+    sys.exit(0 if run() else 1)
+else:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    run(env)  # noqa: F821